@@ -1,235 +1,412 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#include "GrappleGun.h"
-#include "RopeGrappleCharacter.h"
-#include "Components/CapsuleComponent.h"
-
-void UGrappleGun::BeginPlay()
-{
-	traceRadiusIncrease = (maxTraceRadius - minTraceRadius) / (traceBreakUps - 1);
-	gunTipPosition = previousGunTipPosition = GetRopeOrigin();
-	SetTickGroup(ETickingGroup::TG_DuringPhysics);
-}
-
-void UGrappleGun::AssignOwningPlayer(ARopeGrappleCharacter* targetCharacter)
-{
-	if (targetCharacter == nullptr) return;
-	owningPlayer = targetCharacter;
-	owningPlayerGravity = FVector(0, 0, owningPlayer->GetCharacterMovement()->GravityScale * 100);
-}
-
-FVector UGrappleGun::GetRopeOrigin()
-{
-	return GetComponentLocation() + GetComponentRotation().RotateVector(MuzzleOffset);
-}
-
-void UGrappleGun::Fire()
-{
-	if (!owningPlayer || !(owningPlayer->GetController())) return;
-
-	if (FireAnimation) {
-		UAnimInstance* AnimInstance = owningPlayer->GetMesh1P()->GetAnimInstance();
-		if (AnimInstance) AnimInstance->Montage_Play(FireAnimation, 1.f);
-	}
-
-	SearchForRope();
-}
-
-void UGrappleGun::Release()
-{
-	if (rope) rope->Destroy();
-	if (owningPlayer) {
-		owningPlayer->ReleaseAnchor();
-		owningPlayer->EndHanging();
-
-		if (rope && !rope->IsAnchorMovable()) {
-			owningPlayer->GetCharacterMovement()->ClearAccumulatedForces();
-			owningPlayer->GetCharacterMovement()->AddImpulse((gunTipPosition - previousGunTipPosition) * momentumScale / GetWorld()->GetDeltaSeconds());
-			owningPlayer->GetCharacterMovement()->SetMovementMode(EMovementMode::MOVE_Falling);
-		}		
-		hanging = false;
-	}
-
-	rope = nullptr;
-	UGameplayStatics::SetSoundMixClassOverride(this, fireSoundMix, fireSoundClass, 1.0f, 1.0, 0.0f);
-	UGameplayStatics::PushSoundMixModifier(this, fireSoundMix);
-}
-
-void UGrappleGun::SearchForRope()
-{
-	APlayerController* owningController = Cast<APlayerController>(owningPlayer->GetController());
-	UCameraComponent* characterCamera = Cast<UCameraComponent>(owningPlayer->GetComponentByClass(UCameraComponent::StaticClass()));
-	if (!owningController || !characterCamera) return;
-
-	FHitResult hitAnchor = GetAnchorPoint(characterCamera->GetComponentLocation(), characterCamera->GetForwardVector());
-	AActor* anchorObject = hitAnchor.GetActor();
-	if (anchorObject) {
-		if (fireSound) UGameplayStatics::PlaySoundAtLocation(this, fireSound, owningPlayer->GetActorLocation());
-		UGameplayStatics::SetSoundMixClassOverride(this, fireSoundMix, fireSoundClass, GetVolumeByDistance((GetComponentLocation() - hitAnchor.ImpactPoint).Length()), 1.0, 0.02f);
-		UGameplayStatics::PushSoundMixModifier(this, fireSoundMix);
-
-		//Generate the rope on a small delay to allow for synchronization of the SFX
-		FTimerHandle handle;
-		FTimerDelegate delegate;
-		delegate.BindUFunction(this, "GenerateRope", hitAnchor);
-		GetWorld()->GetTimerManager().SetTimer(handle, delegate, 0.1, false);
-	}
-}
-
-void UGrappleGun::GenerateRope(FHitResult hitAnchor)
-{
-	AActor* anchorObject = hitAnchor.GetActor();
-	FVector startLocation = GetRopeOrigin();
-	FVector endLocation = hitAnchor.ImpactPoint;
-
-	rope = GetWorld()->SpawnActor<ARope>();
-	if (rope) {
-		if (anchorObject->Tags.Contains(grappleAnchorTag)) {
-			rope->SetObjectLocks(anchorObject, this);
-			if (owningPlayer) owningPlayer->AnchorMovement(endLocation);
-		}
-		else if (anchorObject->Tags.Contains(grapplePullableTag)) rope->SetObjectLocks(anchorObject, this, true);
-		else return; //eventual option for two-way pull objects..
-
-		rope->SetMeshAndMaterial(mesh, defaultMaterial);
-		rope->GeneratePoints(startLocation, endLocation);
-		rope->SetAnchorNormal(hitAnchor.ImpactNormal);
-	}
-}
-
-FHitResult UGrappleGun::GetAnchorPoint(FVector startLocation, FVector direction)
-{
-	FHitResult outHit;
-	float traceRadius = minTraceRadius;
-	for (int i = 0; i < traceBreakUps; ++i) {
-		UKismetSystemLibrary::SphereTraceSingle(GetWorld(), startLocation + (direction * maxRopeLength * i), startLocation + (direction * maxRopeLength * (i + 1)), traceRadius, UEngineTypes::ConvertToTraceType(grappleCollisionChannel), false, {}, EDrawDebugTrace::None, outHit, true, FLinearColor::Red, FLinearColor::Green, 1.0f);
-		if (outHit.bBlockingHit) return outHit;
-
-		traceRadius += traceRadiusIncrease;
-	}
-
-	return outHit;
-}
-
-void UGrappleGun::PullRopeIn()
-{
-	if (rope) {
-		if (rope->GetLength() <= minRopeLength) return;
-		if (rope->Shorten(ropeLengthChangeSpeed)) {
-			FVector direction = rope->GetAnchorPoint() - GetRopeOrigin();
-			if (owningPlayer->GetCharacterMovement()->MovementMode == EMovementMode::MOVE_Walking && rope->GreaterThanRopeLength(direction)) {
-				if (direction.GetSafeNormal().Z <= zInfluenceRequiredForVertReelIn) owningPlayer->GetCharacterMovement()->AddInputVector(direction * ropeLengthChangeSpeed, true);
-				else owningPlayer->GetCharacterMovement()->AddImpulse(FVector::UpVector * ropeLengthChangeSpeed * verticalReelInForceMultiplier);
-			}
-		}		
-	}
-}
-
-void UGrappleGun::LetRopeOut()
-{
-	if (rope) {
-		if (rope->GetLength() >= maxRopeLength) return;
-		rope->Extend(ropeLengthChangeSpeed);
-	}
-}
-
-void UGrappleGun::SimulateOwningCharacter(float deltaTime)
-{
-	if (owningPlayer->GetCharacterMovement()->MovementMode == EMovementMode::MOVE_Custom) {
-		FVector velocity = gunTipPosition - previousGunTipPosition;
-		previousGunTipPosition = gunTipPosition;
-		gunTipPosition += velocity + owningPlayerGravity * (deltaTime * deltaTime);
-
-		if (pendingForce.SquaredLength() > 0) {
-			gunTipPosition += playerSwingInfluence * FVector(pendingForce.X, pendingForce.Y, 0) * (deltaTime * deltaTime);
-			pendingForce = FVector::ZeroVector;
-		}
-	}
-	else {
-		previousGunTipPosition = gunTipPosition;
-		gunTipPosition = GetRopeOrigin();
-	}
-}
-
-void UGrappleGun::AddForceToPlayer(FVector direction)
-{
-	pendingForce = direction;
-}
-
-void UGrappleGun::RestrainOwningCharacter(URopePoint* endPoint, URopePoint* anchorPoint, float ropeLength)
-{
-	if (!owningPlayer) return;
-
-	FVector ropeOrigin = GetRopeOrigin();
-	if (owningPlayer->GetCharacterMovement()->MovementMode == EMovementMode::MOVE_Falling && (anchorPoint->position - ropeOrigin).SquaredLength() > ropeLength * ropeLength) {
-		owningPlayer->GetCharacterMovement()->SetMovementMode(EMovementMode::MOVE_Custom);
-		owningPlayer->BeginHanging();
-		hanging = true;
-	}
-	else if (owningPlayer->GetCharacterMovement()->MovementMode == EMovementMode::MOVE_Custom) {
-		FVector dummy(ropeOrigin.X, ropeOrigin.Y, anchorPoint->position.Z);
-		owningPlayer->RotateGun(UKismetMathLibrary::FindLookAtRotation(ropeOrigin, dummy + owningPlayer->GetActorForwardVector() * 50));
-
-		//constrain using Jakobsen's
-		FVector difference = endPoint->position - gunTipPosition;
-		float distance = difference.Length() / 2;
-		difference.Normalize();
-		difference *= distance;
-		gunTipPosition += difference;
-
-		//adjust for difference between grapple gun tip and player location and attempt to move there
-		FHitResult movementBlocked;
-		FVector playerLocation = owningPlayer->GetActorLocation();
-		FVector destination = gunTipPosition + (playerLocation - ropeOrigin);
-		owningPlayer->SetActorLocation(destination, true, &movementBlocked);
-
-		//if movement was blocked, use the anchor's direction against the blocking object to project the goal destination out of the collision
-		if (movementBlocked.GetActor()) {
-			FHitResult movementBlockedSecondary;
-			owningPlayer->SetActorLocation(GetNonCollidingLocation(destination, rope->GetAnchorNormal(), playerLocation), true, &movementBlockedSecondary);
-
-			//if THAT movement was blocked, try again with normal off blocking collider (case where anchor is on horizontal surface)
-			if (movementBlockedSecondary.GetActor()) {
-				owningPlayer->SetActorLocation(GetNonCollidingLocation(destination, movementBlocked.Normal, playerLocation), true, &movementBlockedSecondary);
-			}
-		}
-
-		endPoint->position = GetRopeOrigin();
-		CheckForLanding();
-	}
-	else {
-		endPoint->position = ropeOrigin;
-	}
-}
-
-FVector UGrappleGun::GetNonCollidingLocation(FVector idealLocation, FVector blockingNormal, FVector startingLocation)
-{
-	float playerColliderRadius = owningPlayer->GetCapsuleComponent()->GetScaledCapsuleRadius();
-	FVector start = idealLocation + blockingNormal * 3 * playerColliderRadius;
-
-	FHitResult hitActor;
-	UKismetSystemLibrary::SphereTraceSingle(GetWorld(), start, idealLocation, playerColliderRadius, 
-		UEngineTypes::ConvertToTraceType(ECollisionChannel::ECC_Visibility), false, { owningPlayer }, EDrawDebugTrace::None, 
-		hitActor, true, FLinearColor::Red, FLinearColor::Green, 20.0f);
-
-	return (hitActor.bBlockingHit) ? hitActor.Location + blockingNormal : startingLocation;
-}
-
-void UGrappleGun::CheckForLanding()
-{
-	const FVector PawnLocation = owningPlayer->GetActorLocation();
-	FFindFloorResult FloorResult;
-	owningPlayer->GetCharacterMovement()->FindFloor(PawnLocation, FloorResult, false);
-	if (FloorResult.IsWalkableFloor() && owningPlayer->GetCharacterMovement()->IsValidLandingSpot(PawnLocation, FloorResult.HitResult))
-	{
-		owningPlayer->GetCharacterMovement()->SetMovementMode(EMovementMode::MOVE_Falling);
-		owningPlayer->EndHanging();
-		hanging = false;
-	}
-}
-
-float UGrappleGun::GetVolumeByDistance(float distance)
-{
-	float volume = (100 / distance) * (1 / volumeDropOffScale);
-	return FMath::Clamp(volume, minimumVolume, maximumVolume);
-}
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GrappleGun.h"
+#include "RopeGrappleCharacter.h"
+#include "RopeGrappleMovementComponent.h"
+#include "RopePoolSubsystem.h"
+#include "RopeStats.h"
+#include "Net/UnrealNetwork.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+DECLARE_CYCLE_STAT(TEXT("Get Anchor Point"), STAT_RopeGetAnchorPoint, STATGROUP_Rope);
+DECLARE_CYCLE_STAT(TEXT("Restrain Owning Character"), STAT_RopeRestrainOwningCharacter, STATGROUP_Rope);
+
+DEFINE_LOG_CATEGORY_STATIC(LogGrappleGun, Log, All);
+
+UGrappleGun::UGrappleGun()
+{
+	//reeling changes the rope's point count, so it goes in before the rope world gathers its input
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = ETickingGroup::TG_PrePhysics;
+	SetIsReplicatedByDefault(true);
+}
+
+void UGrappleGun::BeginPlay()
+{
+	Super::BeginPlay();
+	traceRadiusIncrease = (maxTraceRadius - minTraceRadius) / (traceBreakUps - 1);
+}
+
+void UGrappleGun::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	if (reelDirection != 0) Reel(DeltaTime);
+}
+
+void UGrappleGun::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(UGrappleGun, grappleState);
+}
+
+void UGrappleGun::AssignOwningPlayer(ARopeGrappleCharacter* targetCharacter)
+{
+	if (targetCharacter == nullptr) return;
+	owningPlayer = targetCharacter;
+}
+
+FVector UGrappleGun::GetRopeOrigin()
+{
+	return GetComponentLocation() + GetComponentRotation().RotateVector(MuzzleOffset);
+}
+
+void UGrappleGun::Fire()
+{
+	if (!owningPlayer || !(owningPlayer->GetController())) return;
+
+	if (FireAnimation) {
+		UAnimInstance* AnimInstance = owningPlayer->GetMesh1P()->GetAnimInstance();
+		if (AnimInstance) AnimInstance->Montage_Play(FireAnimation, 1.f);
+	}
+
+	APlayerController* owningController = Cast<APlayerController>(owningPlayer->GetController());
+	UCameraComponent* characterCamera = Cast<UCameraComponent>(owningPlayer->GetComponentByClass(UCameraComponent::StaticClass()));
+	if (!owningController || !characterCamera) return;
+
+	//the owning client fires straight away; the server repeats the trace from the same view to decide whether it held
+	FVector startLocation = characterCamera->GetComponentLocation();
+	FVector direction = characterCamera->GetForwardVector();
+	SearchForRope(startLocation, direction);
+	if (!owningPlayer->HasAuthority()) ServerFire(startLocation, direction, ++localAction);
+}
+
+void UGrappleGun::ServerFire_Implementation(FVector_NetQuantize startLocation, FVector_NetQuantizeNormal direction, uint8 action)
+{
+	//the client's view is only trusted as far as it could have drifted from where the server has the character
+	pendingAction = action;
+	UCameraComponent* characterCamera = (owningPlayer) ? owningPlayer->GetFirstPersonCameraComponent() : nullptr;
+	if (characterCamera && FVector::Dist(characterCamera->GetComponentLocation(), startLocation) <= maxFireOriginError) SearchForRope(startLocation, direction);
+	else grappleState.acknowledgedAction = pendingAction;
+}
+
+void UGrappleGun::Release()
+{
+	ReleaseLocal();
+	if (owningPlayer && !owningPlayer->HasAuthority()) ServerRelease(++localAction);
+}
+
+void UGrappleGun::ServerRelease_Implementation(uint8 action)
+{
+	grappleState.acknowledgedAction = action;
+	ReleaseLocal();
+}
+
+void UGrappleGun::ReleaseLocal()
+{
+	if (ControlsCharacter()) {
+		owningPlayer->ReleaseAnchor();
+		owningPlayer->EndHanging();
+
+		//the swing's velocity carries on into the fall, with a push along it on top
+		URopeGrappleMovementComponent* movement = owningPlayer->GetRopeMovement();
+		movement->ClearRopeConstraint();
+		if (movement->IsRopeSwinging()) {
+			movement->ClearAccumulatedForces();
+			movement->AddImpulse(movement->Velocity * momentumScale);
+			movement->SetMovementMode(EMovementMode::MOVE_Falling);
+		}
+	}
+
+	if (rope) GetWorld()->GetSubsystem<URopePoolSubsystem>()->ReleaseRope(rope);
+	rope = nullptr;
+	hasKeyframe = false;
+	if (GetOwnerRole() == ROLE_Authority) grappleState.anchor = nullptr;
+
+	//the sound mix is global, so only the player doing the grappling hears it change
+	if (owningPlayer && owningPlayer->IsLocallyControlled()) {
+		UGameplayStatics::SetSoundMixClassOverride(this, fireSoundMix, fireSoundClass, 1.0f, 1.0, 0.0f);
+		UGameplayStatics::PushSoundMixModifier(this, fireSoundMix);
+	}
+}
+
+void UGrappleGun::OnRep_GrappleState()
+{
+	if (owningPlayer && owningPlayer->IsLocallyControlled() && grappleState.acknowledgedAction != localAction) return;
+
+	//the server missed what the client hit, hit something else, or dropped the rope
+	AActor* anchorObject = grappleState.anchor;
+	if (rope && rope->GetAnchorObject() != anchorObject) ReleaseLocal();
+	if (anchorObject && !rope) AttachRope(anchorObject, grappleState.anchorLocation, grappleState.anchorNormal);
+}
+
+void UGrappleGun::SearchForRope(const FVector& startLocation, const FVector& direction)
+{
+	FHitResult hitAnchor = GetAnchorPoint(startLocation, direction);
+	AActor* anchorObject = hitAnchor.GetActor();
+	if (!anchorObject) {
+		if (GetOwnerRole() == ROLE_Authority) grappleState.acknowledgedAction = pendingAction;
+		return;
+	}
+
+	if (owningPlayer->IsLocallyControlled()) {
+		if (fireSound) UGameplayStatics::PlaySoundAtLocation(this, fireSound, owningPlayer->GetActorLocation());
+		UGameplayStatics::SetSoundMixClassOverride(this, fireSoundMix, fireSoundClass, GetVolumeByDistance((GetComponentLocation() - hitAnchor.ImpactPoint).Length()), 1.0, 0.02f);
+		UGameplayStatics::PushSoundMixModifier(this, fireSoundMix);
+	}
+
+	//Generate the rope on a small delay to allow for synchronization of the SFX
+	FTimerHandle handle;
+	FTimerDelegate delegate;
+	delegate.BindUFunction(this, "GenerateRope", hitAnchor);
+	GetWorld()->GetTimerManager().SetTimer(handle, delegate, 0.1, false);
+}
+
+void UGrappleGun::GenerateRope(FHitResult hitAnchor)
+{
+	//a rope the server attached while this one waited on its delay already stands in for it
+	if (!rope) AttachRope(hitAnchor.GetActor(), hitAnchor.ImpactPoint, hitAnchor.ImpactNormal);
+	if (GetOwnerRole() == ROLE_Authority) grappleState.acknowledgedAction = pendingAction;
+}
+
+bool UGrappleGun::AttachRope(AActor* anchorObject, const FVector& anchorLocation, const FVector& anchorNormal)
+{
+	if (!IsValid(anchorObject)) return false;
+	FVector startLocation = GetRopeOrigin();
+	FVector endLocation = anchorLocation;
+
+	URopePoolSubsystem* ropePool = GetWorld()->GetSubsystem<URopePoolSubsystem>();
+	rope = ropePool->AcquireRope();
+	if (!rope) return false;
+
+	if (anchorObject->Tags.Contains(grappleAnchorTag)) {
+		rope->SetObjectLocks(anchorObject, this);
+		if (owningPlayer) owningPlayer->AnchorMovement(endLocation);
+	}
+	else if (anchorObject->Tags.Contains(grapplePullableTag)) rope->SetObjectLocks(anchorObject, this, true);
+	else { //eventual option for two-way pull objects..
+		ropePool->ReleaseRope(rope);
+		rope = nullptr;
+		return false;
+	}
+
+	rope->SetMeshAndMaterial(mesh, defaultMaterial);
+	rope->GeneratePoints(startLocation, endLocation);
+	rope->SetAnchorNormal(anchorNormal);
+	hasKeyframe = false;
+	streamTime = 0.0f;
+	streamBytes = 0;
+	largestSnapshotBytes = 0;
+
+	if (GetOwnerRole() == ROLE_Authority) {
+		grappleState.anchor = anchorObject;
+		grappleState.anchorLocation = anchorLocation;
+		grappleState.anchorNormal = anchorNormal;
+	}
+	return true;
+}
+
+FHitResult UGrappleGun::GetAnchorPoint(FVector startLocation, FVector direction)
+{
+	SCOPE_ROPE_CYCLE_COUNTER(GetAnchorPoint);
+
+	FHitResult outHit;
+	float traceRadius = minTraceRadius;
+	for (int i = 0; i < traceBreakUps; ++i) {
+		UKismetSystemLibrary::SphereTraceSingle(GetWorld(), startLocation + (direction * maxRopeLength * i), startLocation + (direction * maxRopeLength * (i + 1)), traceRadius, UEngineTypes::ConvertToTraceType(grappleCollisionChannel), false, {}, EDrawDebugTrace::None, outHit, true, FLinearColor::Red, FLinearColor::Green, 1.0f);
+		INC_ROPE_COUNTER(Traces, 1);
+		if (outHit.bBlockingHit) return outHit;
+
+		traceRadius += traceRadiusIncrease;
+	}
+
+	return outHit;
+}
+
+void UGrappleGun::PullRopeIn()
+{
+	SetReelDirection(-1);
+}
+
+void UGrappleGun::LetRopeOut()
+{
+	SetReelDirection(1);
+}
+
+void UGrappleGun::StopReeling()
+{
+	SetReelDirection(0);
+}
+
+void UGrappleGun::SetReelDirection(int8 direction)
+{
+	//the reel keys trigger every frame they are held, but the server only hears about a change
+	if (direction == reelDirection) return;
+	reelDirection = direction;
+	if (owningPlayer && !owningPlayer->HasAuthority()) ServerSetReelDirection(direction);
+}
+
+void UGrappleGun::ServerSetReelDirection_Implementation(int8 direction)
+{
+	reelDirection = FMath::Clamp<int8>(direction, -1, 1);
+}
+
+void UGrappleGun::Reel(float DeltaTime)
+{
+	if (!rope) return;
+
+	//both ends reel at reelSpeed on their own clocks, held inside [minRopeLength, maxRopeLength], so a client can't
+	//reel faster or further by sending more often; snapshots settle whatever the two clocks disagree on
+	float length = rope->GetLength();
+	if (reelDirection > 0) {
+		float amount = FMath::Min(reelSpeed * DeltaTime, maxRopeLength - length);
+		if (amount > 0.0f) rope->Extend(amount);
+		return;
+	}
+
+	float amount = FMath::Min(reelSpeed * DeltaTime, length - minRopeLength);
+	if (amount <= 0.0f || !rope->Shorten(amount) || !owningPlayer) return;
+	FVector direction = rope->GetAnchorPoint() - GetRopeOrigin();
+	if (owningPlayer->GetCharacterMovement()->MovementMode == EMovementMode::MOVE_Walking && rope->GreaterThanRopeLength(direction)) {
+		if (direction.GetSafeNormal().Z <= zInfluenceRequiredForVertReelIn) owningPlayer->GetCharacterMovement()->AddInputVector(direction * amount, true);
+		else owningPlayer->GetCharacterMovement()->AddImpulse(FVector::UpVector * amount * verticalReelInForceMultiplier);
+	}
+}
+
+void UGrappleGun::WakeRope()
+{
+	if (rope) rope->WakeUp();
+}
+
+void UGrappleGun::GatherRopeInput(FRopeTickInput& input, const FVector& pivotPosition, float ropeLength)
+{
+	FVector ropeOrigin = GetRopeOrigin();
+	input.heldPosition = ropeOrigin;
+	if (!ControlsCharacter()) return;
+	SCOPE_ROPE_CYCLE_COUNTER(RestrainOwningCharacter);
+
+	//the character's movement carries the swing, so the rope holds on to the gun and tells the movement how far it may go.
+	//the pivot and length come from this machine's own rope, not from the move, so a move replayed after a correction is
+	//held by the rope as it is now; the owning client's rope is kept close to the server's by its snapshots
+	URopeGrappleMovementComponent* movement = owningPlayer->GetRopeMovement();
+	movement->SetRopeConstraint(pivotPosition, ropeLength, ropeOrigin - owningPlayer->GetActorLocation());
+	if (movement->MovementMode == EMovementMode::MOVE_Falling && (pivotPosition - ropeOrigin).SquaredLength() > ropeLength * ropeLength) movement->StartRopeSwing();
+}
+
+void UGrappleGun::ApplyRopeOutput(const FRopeTickOutput& output, URopePoint* endPoint, URopePoint* anchorPoint)
+{
+	FVector ropeOrigin = GetRopeOrigin();
+	endPoint->SetPosition(ropeOrigin);
+	if (!IsHanging()) return;
+
+	FVector dummy(ropeOrigin.X, ropeOrigin.Y, anchorPoint->GetPosition().Z);
+	owningPlayer->RotateGun(UKismetMathLibrary::FindLookAtRotation(ropeOrigin, dummy + owningPlayer->GetActorForwardVector() * 50));
+}
+
+bool UGrappleGun::IsHanging() const
+{
+	return ControlsCharacter() && owningPlayer->GetRopeMovement()->IsRopeSwinging();
+}
+
+bool UGrappleGun::ControlsCharacter() const
+{
+	//remote characters arrive through movement replication; their rope only follows the gun
+	return owningPlayer && (owningPlayer->HasAuthority() || owningPlayer->IsLocallyControlled());
+}
+
+void UGrappleGun::SendRopeSnapshot(float DeltaTime)
+{
+	if (!rope || GetOwnerRole() != ROLE_Authority || GetNetMode() == NM_Standalone) return;
+
+	measureTime += DeltaTime;
+	streamTime += DeltaTime;
+	if (measureTime >= 1.0f) {
+		snapshotBytesPerSecond = measureBytes / measureTime;
+		measureTime = 0.0f;
+		measureBytes = 0;
+
+		//the bucket starts at most full and never lends more than one snapshot, so that is all a stream may be ahead of the limit by
+		float allowedBytes = snapshotBandwidthLimit * (streamTime + 1.0f) + largestSnapshotBytes;
+		UE_LOG(LogGrappleGun, Verbose, TEXT("%s: %.0f snapshot bytes a second (limit %.0f), %lld bytes in %.1f s"), *GetPathName(), snapshotBytesPerSecond, snapshotBandwidthLimit, streamBytes, streamTime);
+		if (streamBytes > allowedBytes) UE_LOG(LogGrappleGun, Warning, TEXT("%s sent %lld snapshot bytes in %.1f s, over the %.0f allowed by snapshotBandwidthLimit"), *GetPathName(), streamBytes, streamTime, allowedBytes);
+	}
+
+	//a token bucket holds the stream to snapshotBandwidthLimit however long the rope gets; a snapshot bigger than the
+	//budget still goes out, and the debt it leaves holds back the following ones until the bucket has refilled
+	snapshotBudget = FMath::Min(snapshotBudget + snapshotBandwidthLimit * DeltaTime, snapshotBandwidthLimit);
+	snapshotTimer += DeltaTime;
+	if (snapshotTimer < 1.0f / snapshotRate || snapshotBudget <= 0.0f) return;
+
+	//keyframes keep coming while the rope sleeps, so late joiners and lost packets still catch up
+	bool keyframe = !hasKeyframe || sendsSinceKeyframe >= snapshotKeyframeInterval;
+	if (rope->IsSleeping() && !keyframe) {
+		snapshotTimer = 0.0f;
+		++sendsSinceKeyframe;
+		return;
+	}
+
+	FRopeSnapshot snapshot;
+	rope->CaptureSnapshot(snapshot);
+	FBitWriter writer(0, true);
+	if (keyframe) snapshot.Serialize(writer);
+	else snapshot.SerializeDelta(writer, snapshotKeyframe);
+
+	int bytes = writer.GetNumBytes();
+	snapshotBudget -= bytes;
+	snapshotTimer = 0.0f;
+
+	if (keyframe) {
+		snapshotKeyframe = MoveTemp(snapshot);
+		++keyframeSequence;
+		hasKeyframe = true;
+		sendsSinceKeyframe = 0;
+	}
+	else ++sendsSinceKeyframe;
+
+	FRopeSnapshotPacket packet;
+	packet.keyframe = keyframe;
+	packet.keyframeSequence = keyframeSequence;
+	packet.numBits = writer.GetNumBits();
+	packet.data.Append(writer.GetData(), writer.GetNumBytes());
+	MulticastRopeSnapshot(packet);
+
+	INC_ROPE_COUNTER(SnapshotBytes, bytes);
+	snapshotBytesSent += bytes;
+	measureBytes += bytes;
+	streamBytes += bytes;
+	largestSnapshotBytes = FMath::Max(largestSnapshotBytes, bytes);
+}
+
+void UGrappleGun::MulticastRopeSnapshot_Implementation(const FRopeSnapshotPacket& packet)
+{
+	if (GetOwnerRole() == ROLE_Authority || !rope) return;
+
+	//a delta whose keyframe was lost is dropped; the next keyframe brings the rope back in step
+	FRopeSnapshot snapshot;
+	FBitReader reader(const_cast<uint8*>(packet.data.GetData()), FMath::Min<int64>(packet.numBits, packet.data.Num() * 8));
+	if (packet.keyframe) snapshot.Serialize(reader);
+	else if (hasKeyframe && packet.keyframeSequence == keyframeSequence) snapshot.SerializeDelta(reader, snapshotKeyframe);
+	else return;
+	if (reader.IsError()) return;
+
+	if (packet.keyframe) {
+		snapshotKeyframe = snapshot;
+		keyframeSequence = packet.keyframeSequence;
+		hasKeyframe = true;
+	}
+	ReceiveRopeSnapshot(snapshot);
+}
+
+void UGrappleGun::ReceiveRopeSnapshot(const FRopeSnapshot& snapshot)
+{
+	if (!owningPlayer || !owningPlayer->IsLocallyControlled()) {
+		rope->ApplySnapshot(snapshot);
+		return;
+	}
+
+	//the owning client's rope runs ahead of a snapshot that is already half a round trip old, so a point reeled in or out
+	//in the meantime is expected; points are matched from the anchor and only a clear divergence is corrected
+	FRopeSnapshot predicted;
+	rope->CaptureSnapshot(predicted);
+	bool diverged = FMath::Abs(predicted.Num() - snapshot.Num()) > 1;
+	for (int i = 1; i < FMath::Min(predicted.Num(), snapshot.Num()) && !diverged; ++i) {
+		diverged = FVector::DistSquared(predicted.GetPosition(predicted.Num() - i), snapshot.GetPosition(snapshot.Num() - i)) > reconcileTolerance * reconcileTolerance;
+	}
+	if (diverged) rope->ApplySnapshot(snapshot);
+}
+
+float UGrappleGun::GetVolumeByDistance(float distance)
+{
+	float volume = (100 / distance) * (1 / volumeDropOffScale);
+	return FMath::Clamp(volume, minimumVolume, maximumVolume);
+}
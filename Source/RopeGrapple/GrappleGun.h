@@ -1,107 +1,203 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Components/SkeletalMeshComponent.h"
-#include "GameFramework/PlayerController.h"
-#include "Camera/CameraComponent.h"
-#include "Kismet/GameplayStatics.h"
-#include "Kismet/KismetMathLibrary.h"
-#include "Rope.h"
-#include "GrappleGun.generated.h"
-
-class ARopeGrappleCharacter;
-
-UCLASS(Blueprintable, BlueprintType, ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
-class ROPEGRAPPLE_API UGrappleGun : public USkeletalMeshComponent
-{
-	GENERATED_BODY()
-
-public:
-	void AssignOwningPlayer(ARopeGrappleCharacter* targetCharacter);
-	void Fire();
-	void Release();
-	void PullRopeIn();
-	void LetRopeOut();
-
-	void RestrainOwningCharacter(URopePoint* endPoint, URopePoint* anchorPoint, float ropeLength);
-	void SimulateOwningCharacter(float deltaTime);
-	void AddForceToPlayer(FVector direction);
-
-	FVector GetRopeOrigin();
-	bool IsHanging() { return hanging; };
-	float GetRopeLength() { return (rope) ? rope->GetLength() : 0.0f; };
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		USoundBase* fireSound;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		USoundClass* fireSoundClass;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		USoundMix* fireSoundMix;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		UAnimMontage* FireAnimation;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		FVector MuzzleOffset = FVector(100.0f, 0.0f, 10.0f);
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		float minTraceRadius = 5.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		float maxTraceRadius = 50.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		float maxRopeLength = 1000.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		float minRopeLength = 200.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		int traceBreakUps = 3;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		TEnumAsByte<ECollisionChannel> grappleCollisionChannel;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		FName grappleAnchorTag = "GrappleAnchor";
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		FName grapplePullableTag = "GrapplePullable";
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		float ropeLengthChangeSpeed = 0.5f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		float zInfluenceRequiredForVertReelIn = 0.6f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		float verticalReelInForceMultiplier = 5.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		float playerSwingInfluence = 2700;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		float momentumScale = 50;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		float volumeDropOffScale = 1;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		float minimumVolume = 0.4f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
-		float maximumVolume = 1.2f;
-
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grapple Options")
-		UStaticMesh* mesh;
-	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Grapple Options")
-		class UMaterialInterface* defaultMaterial;
-
-
-protected:
-	virtual void BeginPlay() override;
-
-	UFUNCTION()
-	void GenerateRope(FHitResult hitAnchor);
-	void SearchForRope();
-	FHitResult GetAnchorPoint(FVector startLocation, FVector direction);
-	FVector GetNonCollidingLocation(FVector idealLocation, FVector blockingNormal, FVector startingLocation);
-	void CheckForLanding();
-	float GetVolumeByDistance(float distance);
-
-	ARopeGrappleCharacter* owningPlayer;
-	ARope* rope;
-	float traceRadiusIncrease;
-	FVector pendingForce;
-
-	FVector gunTipPosition;
-	FVector previousGunTipPosition;
-	FVector owningPlayerGravity;
-	bool hanging = false;
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/CameraComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "Rope.h"
+#include "RopeSnapshot.h"
+#include "Engine/NetSerialization.h"
+#include "GrappleGun.generated.h"
+
+class ARopeGrappleCharacter;
+
+/** What the server's rope is attached to, replicated so every other machine can attach its own copy */
+USTRUCT()
+struct FGrappleState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		AActor* anchor = nullptr;
+	UPROPERTY()
+		FVector_NetQuantize anchorLocation;
+	UPROPERTY()
+		FVector_NetQuantizeNormal anchorNormal;
+	//the last fire or release from the owning client the server has handled; until it catches up, the client's prediction stands
+	UPROPERTY()
+		uint8 acknowledgedAction = 0;
+};
+
+/** A rope snapshot on its way to clients, either a keyframe or a delta against the keyframe with the same sequence */
+USTRUCT()
+struct FRopeSnapshotPacket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		bool keyframe = false;
+	UPROPERTY()
+		uint8 keyframeSequence = 0;
+	UPROPERTY()
+		int32 numBits = 0;
+	UPROPERTY()
+		TArray<uint8> data;
+};
+
+/**
+ * Fires and reels the grapple rope. In multiplayer every machine runs its own pooled rope, but only the server's
+ * is authoritative: the owning client fires and reels straight away and sends the same actions to the server
+ * (the swing itself is a movement mode, so it travels with the character's moves), remote clients attach their copy when the replicated grapple state says so, and the server streams
+ * quantized rope snapshots (keyframes plus deltas) at snapshotRate, averaging no more than snapshotBandwidthLimit
+ * bytes a second per rope. Remote ropes take every snapshot; the owning client only snaps to one once its prediction
+ * has drifted past reconcileTolerance. `stat Rope` shows the bytes sent, snapshotBytesPerSecond the rate over the last
+ * second, and `log LogGrappleGun Verbose` logs that rate against the limit, with a warning if a stream ever outruns its
+ * token bucket. Reeling isn't streamed: the owning client only tells the server which way it is reeling when that
+ * changes, and both reel at reelSpeed on their own ticks.
+ *
+ * To try it on one machine, play in editor with Net Mode set to Play As Listen Server and two or more players, or
+ * run `RopeGrapple.uproject /Game/Maps/City?listen -game` and `RopeGrapple.uproject 127.0.0.1 -game`, adding
+ * `NetEmulation.PktLag` and `NetEmulation.PktLoss` from the console to see prediction under latency.
+ */
+UCLASS(Blueprintable, BlueprintType, ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class ROPEGRAPPLE_API UGrappleGun : public USkeletalMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	UGrappleGun();
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	void AssignOwningPlayer(ARopeGrappleCharacter* targetCharacter);
+	void Fire();
+	void Release();
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	void PullRopeIn();
+	void LetRopeOut();
+	void StopReeling();
+
+	void GatherRopeInput(FRopeTickInput& input, const FVector& pivotPosition, float ropeLength);
+	void ApplyRopeOutput(const FRopeTickOutput& output, URopePoint* endPoint, URopePoint* anchorPoint);
+	void SendRopeSnapshot(float DeltaTime);
+	void WakeRope();
+
+	FVector GetRopeOrigin();
+	bool IsHanging() const;
+	float GetRopeLength() { return (rope) ? rope->GetLength() : 0.0f; };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		USoundBase* fireSound;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		USoundClass* fireSoundClass;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		USoundMix* fireSoundMix;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		UAnimMontage* FireAnimation;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		FVector MuzzleOffset = FVector(100.0f, 0.0f, 10.0f);
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		float minTraceRadius = 5.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		float maxTraceRadius = 50.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		float maxRopeLength = 1000.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		float minRopeLength = 200.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		int traceBreakUps = 3;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		TEnumAsByte<ECollisionChannel> grappleCollisionChannel;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		FName grappleAnchorTag = "GrappleAnchor";
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		FName grapplePullableTag = "GrapplePullable";
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		float reelSpeed = 30.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		float zInfluenceRequiredForVertReelIn = 0.6f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		float verticalReelInForceMultiplier = 5.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		float momentumScale = 50;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		float volumeDropOffScale = 1;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		float minimumVolume = 0.4f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		float maximumVolume = 1.2f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options", meta = (ClampMin = "0.1"))
+		float snapshotRate = 10.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options", meta = (ClampMin = "0"))
+		int snapshotKeyframeInterval = 10;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options", meta = (ClampMin = "256"))
+		float snapshotBandwidthLimit = 2048.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		float reconcileTolerance = 100.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		float maxFireOriginError = 200.0f;
+	UPROPERTY(VisibleInstanceOnly, Transient, Category = "Grapple Stats")
+		float snapshotBytesPerSecond;
+	UPROPERTY(VisibleInstanceOnly, Transient, Category = "Grapple Stats")
+		int snapshotBytesSent;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grapple Options")
+		UStaticMesh* mesh;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Grapple Options")
+		class UMaterialInterface* defaultMaterial;
+
+
+protected:
+	virtual void BeginPlay() override;
+
+	UFUNCTION()
+	void GenerateRope(FHitResult hitAnchor);
+	UFUNCTION(Server, Reliable)
+	void ServerFire(FVector_NetQuantize startLocation, FVector_NetQuantizeNormal direction, uint8 action);
+	UFUNCTION(Server, Reliable)
+	void ServerRelease(uint8 action);
+	UFUNCTION(Server, Reliable)
+	void ServerSetReelDirection(int8 direction);
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastRopeSnapshot(const FRopeSnapshotPacket& packet);
+	UFUNCTION()
+	void OnRep_GrappleState();
+
+	bool AttachRope(AActor* anchorObject, const FVector& anchorLocation, const FVector& anchorNormal);
+	void ReleaseLocal();
+	void SetReelDirection(int8 direction);
+	void Reel(float DeltaTime);
+	void SearchForRope(const FVector& startLocation, const FVector& direction);
+	void ReceiveRopeSnapshot(const FRopeSnapshot& snapshot);
+	bool ControlsCharacter() const;
+	FHitResult GetAnchorPoint(FVector startLocation, FVector direction);
+	float GetVolumeByDistance(float distance);
+
+	ARopeGrappleCharacter* owningPlayer;
+	ARope* rope;
+	float traceRadiusIncrease;
+	//-1 while reeling in, 1 while letting out
+	int8 reelDirection = 0;
+
+	UPROPERTY(ReplicatedUsing = OnRep_GrappleState)
+		FGrappleState grappleState;
+	uint8 localAction = 0;
+	uint8 pendingAction = 0;
+
+	FRopeSnapshot snapshotKeyframe;
+	uint8 keyframeSequence = 0;
+	bool hasKeyframe = false;
+	int sendsSinceKeyframe = 0;
+	float snapshotTimer = 0.0f;
+	float snapshotBudget = 0.0f;
+	float measureTime = 0.0f;
+	int measureBytes = 0;
+	float streamTime = 0.0f;
+	int64 streamBytes = 0;
+	int largestSnapshotBytes = 0;
+};
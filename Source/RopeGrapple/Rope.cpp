@@ -1,338 +1,1118 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "Rope.h"
-#include "GrappleGun.h"
-
-ARope::ARope()
-{
-	PrimaryActorTick.bCanEverTick = true;
-	splineComponent = CreateDefaultSubobject<USplineComponent>("Spline");
-	splineComponent->bDrawDebug = true;
-}
-
-void ARope::BeginPlay()
-{
-	Super::BeginPlay();	
-	SetTickGroup(ETickingGroup::TG_DuringPhysics);
-}
-
-void ARope::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-	for (int i = 0; i < ropePoints.Num(); ++i) {
-		ropePoints[i]->UpdatePoint(DeltaTime);
-	}
-
-	if (anchorIsMovable) {
-		SimulateAnchoredObject(DeltaTime);
-		RestrainAnchoredObject();
-	}
-	else {
-		float currentRopeLength = ropeLength + transitionaryOutDistance - (realDistanceBetweenPoints - transitionaryInDistance);
-		grappleSource->SimulateOwningCharacter(DeltaTime);
-		grappleSource->RestrainOwningCharacter(ropePoints[0], ropePoints[ropePoints.Num() - 1], currentRopeLength);
-	}
-
-	RestrainPoints(constraintIterations / 3);
-	ProjectPoints();
-	RestrainPoints(2 * constraintIterations / 3);
-	GenerateLine();
-}
-
-void ARope::GeneratePoints(FVector startLocation, FVector endLocation)
-{
-	if (!GetWorld()) return;
-	ropePoints.Empty();
-
-	ropeLength = FVector::Dist(startLocation, endLocation);
-	int segments = FMath::CeilToInt(ropeLength / desiredDistanceBetweenPoints);
-	realDistanceBetweenPoints = ropeLength / segments;
-	transitionaryInDistance = realDistanceBetweenPoints;
-
-	FVector location = startLocation;
-	FVector displacement = endLocation - startLocation;
-	displacement.Normalize();
-	displacement *= realDistanceBetweenPoints;
-
-	//there should be one more point than segments
-	for (int i = 0; i <= segments; ++i) {
-		ropePoints.Emplace(NewObject<URopePoint>());
-		ropePoints[i]->RegisterComponent();
-		ropePoints[i]->position = location;
-		ropePoints[i]->previousPosition = location;
-
-		location += displacement;
-	}
-
-	//insert an artificial point at the same position as the anchor to be used as the point transitioning out (adding points)
-	transitionaryOutIndex = segments;
-	ropePoints.EmplaceAt(transitionaryOutIndex, NewObject<URopePoint>());
-	ropePoints[transitionaryOutIndex]->RegisterComponent();
-	ropePoints[transitionaryOutIndex]->position = ropePoints[transitionaryOutIndex + 1]->position;
-	ropePoints[transitionaryOutIndex]->previousPosition = ropePoints[transitionaryOutIndex + 1]->position;
-
-	//the point right before the transitioning out point will be used as the point transitioning in (removing points)
-	transitionaryInIndex = transitionaryOutIndex - 1;
-
-	//set anchor information
-	if(!anchorIsMovable) ropePoints[ropePoints.Num() - 1]->isAnchor = true;
-	anchorObjectImpactOffset = anchorObject->GetActorLocation() - ropePoints[ropePoints.Num() - 1]->position;
-
-	//initialize visual spline
-	splineComponent->ClearSplinePoints();
-	for (int i = 0; i < ropePoints.Num(); ++i) {
-		splineComponent->AddPoint({ (float)i, ropePoints[i]->position });
-		ropeMeshes.Add(CreateSplineMesh());
-	}
-
-	ropeLength *= initialGiveMultiplier;
-}
-
-void ARope::RestrainPoints(int iters)
-{
-	for (int iterations = 0; iterations < iters; ++iterations) {
-		//the point we're holding is always located at the tip of the grapple gun
-		ropePoints[0]->position = grappleSource->GetRopeOrigin();
-
-		//all the "middle" points are held normally
-		for (int i = 1; i < transitionaryInIndex - 1; ++i) {
-			Constrain(i, i - 1, realDistanceBetweenPoints);
-			Constrain(i + 1, i, realDistanceBetweenPoints);
-		}
-
-		//distance between the two transitionary points is the transition IN dist, dist between out transition and anchor is transition OUT dist
-		if(transitionaryInIndex > 0) Constrain(transitionaryInIndex, transitionaryInIndex - 1, realDistanceBetweenPoints);
-		Constrain(transitionaryOutIndex, transitionaryInIndex, transitionaryInDistance);
-		if(transitionaryOutIndex < ropePoints.Num() - 1) Constrain(transitionaryOutIndex + 1, transitionaryOutIndex, transitionaryOutDistance);
-	}	
-}
-
-void ARope::ProjectPoints()
-{
-	FVector previousNormal = FVector::ZeroVector;
-	for (int i = 1; i < transitionaryInIndex - 1; ++i) {
-		FHitResult outHit;
-		UKismetSystemLibrary::SphereTraceSingle(GetWorld(), ropePoints[i]->position + (FVector::UpVector * desiredDistanceBetweenPoints / 3),
-			ropePoints[i]->position, ropePoints[i]->radius, UEngineTypes::ConvertToTraceType(ECC_Visibility), false, { this }, 
-			EDrawDebugTrace::None, outHit, true, FLinearColor::Red, FLinearColor::Green, 0);
-
-		if (outHit.bBlockingHit && outHit.ImpactNormal.Z >= (majorityInfluence - 1)) {
-			if(outHit.ImpactNormal.Z < majorityInfluence) 
-				UKismetSystemLibrary::SphereTraceSingle(GetWorld(), ropePoints[i]->position + (outHit.ImpactNormal * correctionTraceLength),
-				ropePoints[i]->position, ropePoints[i]->radius, UEngineTypes::ConvertToTraceType(ECC_Visibility), false, { this },
-				EDrawDebugTrace::None, outHit, true, FLinearColor::Red, FLinearColor::Green, 0);
-
-			ProjectPoint(i, outHit.ImpactPoint);
-			float angle = FMath::RadiansToDegrees(acosf(FVector::DotProduct(outHit.ImpactNormal, previousNormal)));
-			if (previousNormal != FVector::ZeroVector && angle > 60) {
-				HandleCorner(i - 1, i, previousNormal, outHit.ImpactNormal);
-			}
-			previousNormal = outHit.ImpactNormal;
-		}
-		else if (outHit.bBlockingHit) previousNormal = outHit.ImpactNormal;
-		else previousNormal = FVector::ZeroVector;
-	}
-}
-
-void ARope::ProjectPoint(int ind, FVector impactPoint, bool groundCollision)
-{
-	float correctionWeight = (groundCollision) ? 0.9 : 0.7;
-	FVector correctedPrevPos = ropePoints[ind]->previousPosition + (impactPoint - ropePoints[ind]->previousPosition) * correctionWeight;
-	ropePoints[ind]->previousPosition = FVector(correctedPrevPos.X, correctedPrevPos.Y, ropePoints[ind]->previousPosition.Z);
-	ropePoints[ind]->position = impactPoint;
-	if (!groundCollision) ropePoints[ind]->position.Z = ropePoints[ind]->previousPosition.Z;
-
-	ropePoints[ind]->collisionsResolved += 2;
-}
-
-void ARope::HandleCorner(int indA, int indB, FVector aImpactNormal, FVector bImpactNormal)
-{
-	FVector current = ropePoints[indB]->position;
-	FVector adjust = aImpactNormal * 10.0f;
-	FVector goal = current + aImpactNormal * realDistanceBetweenPoints * 5;
-
-	FHitResult outHit;
-	FVector lastHit;
-	for (int i = 0; i < 40; ++i) {
-		UKismetSystemLibrary::SphereTraceSingle(GetWorld(), current + (bImpactNormal * correctionTraceLength),
-			current, 10, UEngineTypes::ConvertToTraceType(ECC_Visibility), false, { this },
-			EDrawDebugTrace::None, outHit, true, FLinearColor::Red, FLinearColor::Green, 5);
-
-		if (outHit.bBlockingHit) lastHit = outHit.ImpactPoint;
-		else {
-			//DrawDebugSphere(GetWorld(), lastHit, 5, 8, FColor(181, 0, 200), false, 5, 2, 1);
-			int modifiedInd = (FVector::Distance(lastHit, ropePoints[indA]->position) < FVector::Distance(lastHit, ropePoints[indB]->position)) ? indA : indB;
-			ropePoints[modifiedInd]->position = lastHit;
-			ropePoints[modifiedInd]->cornerFlag = true;
-			break;
-		}
-		current += adjust;
-	}	
-}
-
-void ARope::Constrain(int indA, int indB, float constraintDist)
-{
-	float distance, percent;
-	FVector difference;
-
-	difference = ropePoints[indA]->position - ropePoints[indB]->position;
-	distance = difference.Length() - constraintDist * stiffness;
-	percent = (constraintDist > 0) ? (distance / constraintDist) : 1;
-	percent = FMath::Clamp(percent, 0, 1);
-
-	difference *= percent;
-	if (ropePoints[indB]->isAnchor || ropePoints[indB]->cornerFlag) ropePoints[indA]->position = ropePoints[indA]->position - difference;
-	else if (ropePoints[indA]->isAnchor || ropePoints[indA]->cornerFlag) ropePoints[indB]->position = ropePoints[indB]->position + difference;
-	else {
-		difference /= 2;
-		ropePoints[indB]->position = ropePoints[indB]->position + difference;
-		ropePoints[indA]->position = ropePoints[indA]->position - difference;
-	}
-}
-
-void ARope::SimulateAnchoredObject(float DeltaTime)
-{
-	//allow actual object to simulate its own physics - simply track it for later calculation
-	previousAnchorObjectPosition = anchorObjectPosition;
-	anchorObjectPosition = anchorObject->GetActorLocation();
-}
-
-void ARope::RestrainAnchoredObject()
-{
-	//we only force movement if the rope is taut / actively pulling the object
-	FVector distance = anchorObjectPosition - ropePoints[0]->position;
-	if (GreaterThanRopeLength(distance)) {
-		//calculate a position projected into the allowed radius
-		FVector correctedDistance = distance;
-		correctedDistance.Normalize();
-		correctedDistance *= GetLength() * initialGiveMultiplier;
-
-		//negotiate the physics calculated position with our corrections
-		bool playerAboveObject = ropePoints[0]->position.Z - ropePoints[ropePoints.Num() - 1]->position.Z >= GetLength() * majorityInfluence;
-		float correctionWeight = (playerAboveObject) ? 0.07 : 0.05;
-		float zPos = (!playerAboveObject) ? anchorObjectPosition.Z + (correctedDistance.Z - anchorObjectPosition.Z) * correctionWeight :
-			ropePoints[0]->position.Z + correctedDistance.Z + (anchorObjectPosition.Z - ropePoints[0]->position.Z) * correctionWeight;
-		anchorObjectPosition = FVector(ropePoints[0]->position.X + correctedDistance.X, ropePoints[0]->position.Y + correctedDistance.Y, zPos);
-
-		FHitResult blockingHit;
-		anchorObject->SetActorLocation(anchorObjectPosition, true, &blockingHit);
-
-		//if moving to the corrected location was blocked...
-		if (blockingHit.GetActor()) {
-			FVector origin, boxExtents;
-			anchorObject->GetActorBounds(true, origin, boxExtents, false);
-			FVector start = anchorObjectPosition + FVector::UpVector * boxExtents.GetAbsMax();
-			FVector end = anchorObjectPosition - FVector::UpVector * boxExtents.GetAbsMax();
-
-			FHitResult hitActor;
-			UKismetSystemLibrary::BoxTraceSingle(GetWorld(), start, end, boxExtents, anchorObject->GetActorRotation(), UEngineTypes::ConvertToTraceType(ECollisionChannel::ECC_Visibility), false, { anchorObject }, EDrawDebugTrace::None, hitActor, true, FLinearColor::Red, FLinearColor::Green, 0.2f);
-
-			//only project out of the collision if the normal is reasonable (not a vertical wall)
-			bool notRandomlyUp = (hitActor.Location.Z - previousAnchorObjectPosition.Z < 50) || playerAboveObject;
-			if (hitActor.bBlockingHit && notRandomlyUp && FMath::Abs(hitActor.ImpactNormal.X) < minorityInfluence && FMath::Abs(hitActor.ImpactNormal.Y) < minorityInfluence) {
-				anchorObject->SetActorLocation(hitActor.Location, false);
-
-				FRotator normalDiff = UKismetMathLibrary::FindLookAtRotation(hitActor.ImpactNormal, anchorObject->GetActorUpVector());
-				float angleDiff = FMath::Abs(normalDiff.Yaw + normalDiff.Pitch + normalDiff.Roll);
-				if (angleDiff > 5 && angleDiff < 100) {
-					FRotator NewRotator = UKismetMathLibrary::MakeRotationFromAxes(anchorObject->GetActorForwardVector(), anchorObject->GetActorRightVector(), hitActor.ImpactNormal);
-					anchorObject->SetActorRotation(NewRotator);
-				}
-			}
-			else if (playerAboveObject) { //if we're pulling it up, we can project up a perpendicular surface
-				start = anchorObjectPosition + blockingHit.Normal * boxExtents.GetAbsMax();
-				end = anchorObjectPosition - blockingHit.Normal * boxExtents.GetAbsMax();
-				UKismetSystemLibrary::BoxTraceSingle(GetWorld(), start, end, boxExtents, anchorObject->GetActorRotation(), UEngineTypes::ConvertToTraceType(ECollisionChannel::ECC_Visibility), false, { anchorObject }, EDrawDebugTrace::None, hitActor, true, FLinearColor::Red, FLinearColor::Green, 20.0f);
-				if (hitActor.bBlockingHit) {
-					anchorObject->SetActorLocation(hitActor.Location, false);
-				}
-			}
-		}
-	}	
-
-	anchorObjectPosition = anchorObject->GetActorLocation();
-	ropePoints[ropePoints.Num() - 1]->position = anchorObject->GetActorLocation();
-}
-
-USplineMeshComponent* ARope::CreateSplineMesh()
-{
-	USplineMeshComponent* splineMesh = NewObject<USplineMeshComponent>(this, USplineMeshComponent::StaticClass());
-	splineMesh->SetStaticMesh(mesh);
-	splineMesh->SetForwardAxis(ESplineMeshAxis::Z, true);
-	splineMesh->RegisterComponentWithWorld(GetWorld());
-	splineMesh->SetMobility(EComponentMobility::Movable);
-	splineMesh->AttachToComponent(splineComponent, FAttachmentTransformRules::KeepRelativeTransform);
-	return splineMesh;
-}
-
-void ARope::GenerateLine()
-{
-	/*FColor color; float adjust;
-	for (int i = 0; i < ropePoints.Num(); ++i) {
-		color = (i == transitionaryOutIndex) ? FColor::Red : (i == transitionaryInIndex) ? FColor::Yellow : FColor::Blue;
-		if ((ropePoints[i]->cornerFlag)) color = FColor::Purple;
-		adjust = (i == transitionaryOutIndex) ? 0.75f : 1.0f;
-		DrawDebugSphere(GetWorld(), ropePoints[i]->position, ropePoints[i]->radius * adjust, 16, color, false, 0);
-	}*/
-
-	for (int i = 0; i < ropePoints.Num(); ++i) {
-		splineComponent->SetLocationAtSplinePoint(i, ropePoints[i]->position, ESplineCoordinateSpace::World);
-	}
-
-	for (int i = 0; i < ropePoints.Num() - 1; ++i) {
-		// define the positions of the points and tangents
-		FVector StartPoint = splineComponent->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::Type::Local);
-		FVector StartTangent = splineComponent->GetTangentAtSplinePoint(i, ESplineCoordinateSpace::Type::Local);
-		FVector EndPoint = splineComponent->GetLocationAtSplinePoint(i + 1, ESplineCoordinateSpace::Type::Local);
-		FVector EndTangent = splineComponent->GetTangentAtSplinePoint(i + 1, ESplineCoordinateSpace::Type::Local);
-		if (i == 0) StartPoint = grappleSource->GetRopeOrigin();
-		ropeMeshes[i]->SetStartAndEnd(StartPoint, StartTangent, EndPoint, EndTangent, true);
-	}
-}
-
-bool ARope::Shorten(float rateOfChange)
-{
-	if (ropePoints.Num() <= 4) return false; //a rope is minimum 3 points - start, end, and the artificial transition out point.
-
-	if (transitionaryOutDistance > 0) transitionaryOutDistance -= rateOfChange;
-	else transitionaryInDistance -= rateOfChange;
-
-	if (transitionaryInDistance <= 0) {
-		ropePoints.RemoveAt(transitionaryInIndex);
-		ropeMeshes[transitionaryInIndex]->DestroyComponent();
-		ropeMeshes.RemoveAt(transitionaryInIndex);
-		splineComponent->RemoveSplinePoint(transitionaryInIndex);
-
-		--transitionaryInIndex;
-		--transitionaryOutIndex;
-
-		transitionaryInDistance = realDistanceBetweenPoints;
-		ropeLength -= realDistanceBetweenPoints;
-	}
-
-	return true;
-}
-
-void ARope::Extend(float rateOfChange)
-{
-	if (transitionaryInDistance < realDistanceBetweenPoints) transitionaryInDistance += rateOfChange;
-	else transitionaryOutDistance += rateOfChange;
-
-	if (transitionaryOutDistance >= realDistanceBetweenPoints) {
-		++transitionaryOutIndex;
-		++transitionaryInIndex;
-
-		ropePoints.EmplaceAt(transitionaryOutIndex, NewObject<URopePoint>());
-		ropePoints[transitionaryOutIndex]->RegisterComponent();
-		ropePoints[transitionaryOutIndex]->position = ropePoints[transitionaryOutIndex + 1]->position;
-		ropePoints[transitionaryOutIndex]->previousPosition = ropePoints[transitionaryOutIndex + 1]->position;
-
-		splineComponent->AddSplinePointAtIndex(ropePoints[transitionaryOutIndex + 1]->position, transitionaryOutIndex, ESplineCoordinateSpace::World);
-		ropeMeshes.EmplaceAt(transitionaryOutIndex, CreateSplineMesh());	
-
-		transitionaryOutDistance = 0.0f;
-		ropeLength += realDistanceBetweenPoints;
-	}
-}
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Rope.h"
+#include "GrappleGun.h"
+#include "RopePoolSubsystem.h"
+#include "RopeWorldSubsystem.h"
+#include "RopeStats.h"
+#include "RopeReplay.h"
+#include "RopeSnapshot.h"
+#include "Camera/PlayerCameraManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Simulate"), STAT_RopeSimulate, STATGROUP_Rope);
+DECLARE_CYCLE_STAT(TEXT("Restrain Points"), STAT_RopeRestrainPoints, STATGROUP_Rope);
+DECLARE_CYCLE_STAT(TEXT("Project Points"), STAT_RopeProjectPoints, STATGROUP_Rope);
+DECLARE_CYCLE_STAT(TEXT("Handle Corner"), STAT_RopeHandleCorner, STATGROUP_Rope);
+DECLARE_CYCLE_STAT(TEXT("Generate Line"), STAT_RopeGenerateLine, STATGROUP_Rope);
+DECLARE_CYCLE_STAT(TEXT("Restrain Anchored Object"), STAT_RopeRestrainAnchoredObject, STATGROUP_Rope);
+
+//adds the cycles spent in its scope to one of a rope's phase timings while they are being recorded
+struct FRopePhaseTimer
+{
+	FRopePhaseTimer(bool enabled, uint64& counter_) : counter((enabled) ? &counter_ : nullptr), start((enabled) ? FPlatformTime::Cycles64() : 0) {};
+	~FRopePhaseTimer() { if (counter) *counter += FPlatformTime::Cycles64() - start; };
+
+	uint64* counter;
+	uint64 start;
+};
+
+ARope::ARope()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	splineComponent = CreateDefaultSubobject<USplineComponent>("Spline");
+
+	//the whole rope renders as one tube whose vertices are rewritten each frame, so its cost doesn't grow with segment count
+	tubeMesh = CreateDefaultSubobject<UProceduralMeshComponent>("Tube");
+	tubeMesh->SetupAttachment(splineComponent);
+	tubeMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	lodLevels = { FRopeLodLevel(0.0f, 1.0f, 1.0f, true, 0), FRopeLodLevel(2500.0f, 2.0f, 0.5f, true, 6), FRopeLodLevel(6000.0f, 4.0f, 0.25f, false, 4) };
+}
+
+void ARope::BeginPlay()
+{
+	Super::BeginPlay();	
+	SetTickGroup(ETickingGroup::TG_DuringPhysics);
+}
+
+void ARope::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	//only ropes outside a rope world subsystem tick themselves; the subsystem runs the simulate stage of all its ropes on workers instead
+	if (GatherInput(DeltaTime) > 0) Simulate();
+	ApplyOutput();
+}
+
+void ARope::UpdateLod(float DeltaTime)
+{
+	//without a local camera (a dedicated server) every rope stays at full detail
+	float distance;
+	int lastLod = FMath::Max(0, lodLevels.Num() - 1);
+	if (!useLod || lodLevels.Num() == 0 || !GetNearestViewDistance(distance)) currentLod = 0;
+	else {
+		//a level is entered past its distance plus the hysteresis band and only left once back inside its distance minus it
+		currentLod = FMath::Min(currentLod, lastLod);
+		while (currentLod < lastLod && distance > lodLevels[currentLod + 1].distance * (1 + lodHysteresis)) ++currentLod;
+		while (currentLod > 0 && distance < lodLevels[currentLod].distance * (1 - lodHysteresis)) --currentLod;
+
+		//occluded or off-screen ropes drop to the cheapest level once nobody has seen them for a while
+		UPrimitiveComponent* visual = (useTubeMesh) ? tubeMesh : (ropeMeshes.Num() > 0) ? ropeMeshes[0] : nullptr;
+		offscreenTime = (visual && !visual->WasRecentlyRendered(0.1f)) ? offscreenTime + DeltaTime : 0.0f;
+		if (offscreenTime > lodOffscreenDelay) currentLod = lastLod;
+	}
+	const FRopeLodLevel level = (useLod && lodLevels.IsValidIndex(currentLod)) ? lodLevels[currentLod] : FRopeLodLevel();
+
+	//the iteration budget eases toward the level's so the rope's stretch doesn't change in one frame
+	lodIterationScale = FMath::FInterpConstantTo(lodIterationScale, level.iterationScale, DeltaTime, 1.0f / FMath::Max(lodBlendTime, KINDA_SMALL_NUMBER));
+	tickInput.minIterations = FMath::Max(3, FMath::RoundToInt(minConstraintIterations * lodIterationScale));
+	tickInput.maxIterations = FMath::Max(tickInput.minIterations, FMath::RoundToInt(maxConstraintIterations * lodIterationScale));
+	if (tickInput.projectPoints && !level.projectPoints) pendingProjectionTraces.Reset();
+	tickInput.projectPoints = level.projectPoints;
+	lodTubeSides = (level.tubeSides > 0) ? level.tubeSides : tubeSides;
+
+	//resampling moves every index, so it waits until the rope isn't wrapped over anything
+	float spacing = desiredDistanceBetweenPoints * level.spacingMultiplier;
+	if (!FMath::IsNearlyEqual(spacing, lodSpacing) && wraps.Num() == 0) ResampleRope(spacing);
+}
+
+bool ARope::GetNearestViewDistance(float& outDistance) const
+{
+	//spectator and replay cameras count as much as the player's own, so the nearest local view decides
+	bool foundView = false;
+	FBox ropeBounds = simulation.GetBounds();
+	for (FConstPlayerControllerIterator iterator = GetWorld()->GetPlayerControllerIterator(); iterator; ++iterator) {
+		APlayerController* controller = iterator->Get();
+		if (!controller || !controller->IsLocalController() || !controller->PlayerCameraManager) continue;
+
+		float distance = FMath::Sqrt(ropeBounds.ComputeSquaredDistanceToPoint(controller->PlayerCameraManager->GetCameraLocation()));
+		outDistance = (foundView) ? FMath::Min(outDistance, distance) : distance;
+		foundView = true;
+	}
+	return foundView;
+}
+
+void ARope::ResampleRope(float spacing)
+{
+	//merged or split segments keep the rope's shape, length and motion, so the change doesn't show
+	simulation.Resample(spacing);
+	RecordEvent({ FRopeReplayEvent::EType::Resample, INDEX_NONE, spacing });
+	lodSpacing = spacing;
+	SyncPointViews();
+}
+
+void ARope::SyncPointViews()
+{
+	//the points, meshes and spline follow the simulation whenever its point count changes outside a normal extend or shorten
+	while (ropePoints.Num() > simulation.Num()) ReleaseRopePoint(ropePoints.Pop(false));
+	while (ropePoints.Num() < simulation.Num()) ropePoints.Emplace(CreateRopePoint(ropePoints.Num()));
+	if (!useTubeMesh) {
+		while (ropeMeshes.Num() > simulation.Num()) ReleaseSplineMesh(ropeMeshes.Pop(false));
+		while (ropeMeshes.Num() < simulation.Num()) ropeMeshes.Emplace(AcquireSplineMesh());
+	}
+
+	splineComponent->ClearSplinePoints(false);
+	for (int i = 0; i < simulation.Num(); ++i) {
+		splineComponent->AddPoint({ (float)i, simulation.GetPosition(i) }, false);
+	}
+	splineComponent->UpdateSpline();
+
+	cornerCache.Reset();
+	pendingProjectionTraces.Reset();
+}
+
+int ARope::GatherInput(float DeltaTime)
+{
+	//step the rope at a fixed rate so it behaves the same at any frame rate; time beyond the substep cap is dropped so hitches slow the rope down instead of exploding it
+	timeAccumulator = FMath::Min(timeAccumulator + DeltaTime, fixedTimeStep * maxSubstepsPerFrame);
+	tickInput.substeps = FMath::FloorToInt(timeAccumulator / fixedTimeStep);
+	tickInput.stepTime = fixedTimeStep;
+	timeAccumulator -= tickInput.substeps * fixedTimeStep;
+	tickInput.contacts.Reset();
+	tickInput.newWraps.Reset();
+	tickOutput.substeps = 0;
+	pointsTraced = 0;
+	INC_ROPE_COUNTER(Segments, simulation.Num() - 1);
+
+	//the frame being recorded is already open, since anything reeled in or out between frames belongs to it
+	if (recording) {
+		FRopeReplayFrame& frame = recording->frames.Last();
+		frame.deltaTime = DeltaTime;
+		frame.gunTransform = grappleSource->GetComponentTransform();
+		frame.anchorTransform = (anchorObject) ? anchorObject->GetActorTransform() : FTransform::Identity;
+	}
+
+	//a sleeping rope only checks whether anything around it changed, and keeps no time banked for when it wakes
+	if (sleeping) {
+		timeAccumulator = 0.0f;
+		tickInput.substeps = 0;
+		if (!ShouldWake(DeltaTime)) return 0;
+		WakeUp();
+	}
+	UpdateLod(DeltaTime);
+	if (tickInput.substeps == 0) return 0;
+
+	if (anchorIsMovable) {
+		SimulateAnchoredObject();
+		tickInput.heldPosition = grappleSource->GetRopeOrigin();
+	}
+	else {
+		//the player swings around the wrap nearest to them, on however much rope is left below it
+		int pivotIndex = GetPivotIndex();
+		grappleSource->GatherRopeInput(tickInput, simulation.GetPosition(pivotIndex), GetFreeLength(pivotIndex));
+	}
+
+	//scene queries stay on the game thread, so contacts and corners are found once per frame and applied by its first substep
+	if (tickInput.projectPoints) {
+		SCOPE_ROPE_CYCLE_COUNTER(ProjectPoints);
+		FRopePhaseTimer timer(recordPhaseTimings, phaseTimings.project);
+		GatherContacts();
+	}
+	else projectedWithDistanceField = false;
+
+	//the simulate stage starts straight after the gather, so anything that waits for it to finish is recorded after it
+	if (recording) {
+		recording->frames.Last().input = tickInput;
+		RecordEvent({ FRopeReplayEvent::EType::Simulate });
+	}
+	return tickInput.substeps;
+}
+
+void ARope::Simulate()
+{
+	//may run on a worker: only the simulation, the wraps and the tick input and output are touched here
+	SCOPE_ROPE_CYCLE_COUNTER(Simulate);
+	const float stepTime = tickInput.stepTime;
+	const FVector held = tickInput.heldPosition;
+	tickOutput.iterationsUsed = 0;
+
+	for (int step = 0; step < tickInput.substeps; ++step) {
+		{
+			FRopePhaseTimer timer(recordPhaseTimings, phaseTimings.integrate);
+			simulation.Integrate(stepTime);
+			simulation.SetPosition(0, held);
+		}
+
+		//the floor and ceiling keep the original one third / two thirds split around collision projection
+		{
+			SCOPE_ROPE_CYCLE_COUNTER(RestrainPoints);
+			FRopePhaseTimer timer(recordPhaseTimings, phaseTimings.constrain);
+			tickOutput.iterationsUsed += simulation.SolveConstraints(tickInput.minIterations / 3, tickInput.maxIterations / 3, errorAcceptance, held);
+		}
+		//the contacts and corners belong to the frame rather than the substep, so only the first substep applies them; projecting
+		//again on every substep would pull each point's previous position back onto the impact repeatedly and damp it
+		if (step == 0) {
+			FRopePhaseTimer timer(recordPhaseTimings, phaseTimings.project);
+			for (const FRopeContact& contact : tickInput.contacts) {
+				ProjectPoint(contact.index, contact.impactPoint);
+			}
+			for (const FRopeWrap& wrap : tickInput.newWraps) {
+				WrapPoint(wrap);
+			}
+		}
+		{
+			SCOPE_ROPE_CYCLE_COUNTER(RestrainPoints);
+			FRopePhaseTimer timer(recordPhaseTimings, phaseTimings.constrain);
+			tickOutput.iterationsUsed += simulation.SolveConstraints(2 * tickInput.minIterations / 3, 2 * tickInput.maxIterations / 3, errorAcceptance, held);
+		}
+		ReleaseUnwrappedPoints();
+	}
+
+	tickOutput.substeps = tickInput.substeps;
+	tickOutput.stepTime = stepTime;
+	tickOutput.finalResidual = simulation.GetLastResidual();
+}
+
+void ARope::ApplyOutput()
+{
+	//the simulate stage has finished by now, so the server captures its snapshot here rather than waiting on the stage
+	if (grappleSource) grappleSource->SendRopeSnapshot(GetWorld()->GetDeltaSeconds());
+	if (sleeping) {
+		RecordFrame();
+		return;
+	}
+	if (tickOutput.substeps > 0) {
+		iterationsUsed = tickOutput.iterationsUsed;
+		INC_ROPE_COUNTER(Iterations, iterationsUsed);
+		finalResidual = tickOutput.finalResidual;
+
+		if (anchorIsMovable) RestrainAnchoredObject();
+		else grappleSource->ApplyRopeOutput(tickOutput, ropePoints[0], ropePoints[GetPivotIndex()]);
+		RecordEvent({ FRopeReplayEvent::EType::SetPosition, 0, 0.0f, simulation.GetPosition(0) });
+		RecordEvent({ FRopeReplayEvent::EType::SetPosition, simulation.GetAnchorIndex(), 0.0f, GetAnchorPoint() });
+
+		//sweeps are issued from the solved positions and read back by the next frame's gather
+		if (tickInput.projectPoints && useAsyncCollision && !projectedWithDistanceField && pendingProjectionTraces.Num() == 0) {
+			SCOPE_ROPE_CYCLE_COUNTER(ProjectPoints);
+			FRopePhaseTimer timer(recordPhaseTimings, phaseTimings.project);
+			RequestAsyncProjection();
+		}
+		UpdateSleep();
+	}
+	RecordFrame();
+
+	//the last line drawn before sleeping is left in place
+	GenerateLine((sleeping) ? 1.0f : timeAccumulator / fixedTimeStep);
+}
+
+void ARope::UpdateSleep()
+{
+	//only ropes on a fixed anchor that aren't carrying a swinging player can settle
+	bool still = allowSleep && !anchorIsMovable && !(grappleSource && grappleSource->IsHanging()) && wraps.Num() == 0 &&
+		simulation.ComputeMaxDisplacement() <= sleepDisplacement && tickOutput.finalResidual <= sleepResidual;
+	stillTime = (still) ? stillTime + tickOutput.substeps * tickOutput.stepTime : 0.0f;
+	if (stillTime < sleepDelay) return;
+
+	//remember what the rope was resting on so a change to it can wake the rope
+	simulation.ClearVelocities();
+	RecordEvent({ FRopeReplayEvent::EType::ClearVelocities });
+	FBox ropeBounds = simulation.GetBounds().ExpandBy(simulation.pointRadius + desiredDistanceBetweenPoints / 3);
+	GatherGeometryBounds(ropeBounds, sleepGeometryBounds);
+	sleepGeometryCheckTime = sleepGeometryCheckInterval;
+	pendingProjectionTraces.Reset();
+	sleeping = true;
+}
+
+bool ARope::ShouldWake(float DeltaTime)
+{
+	//the player walking off with the gun or the anchor being moved pulls on the rope straight away
+	if (FVector::DistSquared(grappleSource->GetRopeOrigin(), simulation.GetPosition(0)) > FMath::Square(sleepWakeDistance)) return true;
+	if (anchorObject && FVector::DistSquared(GetAnchorObjectPoint(), GetAnchorPoint()) > FMath::Square(sleepWakeDistance)) return true;
+
+	//geometry appearing, moving or going away under the rope is only looked for every so often
+	sleepGeometryCheckTime -= DeltaTime;
+	if (sleepGeometryCheckTime > 0) return false;
+	sleepGeometryCheckTime = sleepGeometryCheckInterval;
+
+	FBox ropeBounds = simulation.GetBounds().ExpandBy(simulation.pointRadius + desiredDistanceBetweenPoints / 3);
+	GatherGeometryBounds(ropeBounds, wakeGeometryBounds);
+	if (wakeGeometryBounds.Num() != sleepGeometryBounds.Num()) return true;
+	for (int i = 0; i < wakeGeometryBounds.Num(); ++i) {
+		if (!wakeGeometryBounds[i].Min.Equals(sleepGeometryBounds[i].Min, sleepWakeDistance) || !wakeGeometryBounds[i].Max.Equals(sleepGeometryBounds[i].Max, sleepWakeDistance)) return true;
+	}
+	return false;
+}
+
+void ARope::WakeUp()
+{
+	sleeping = false;
+	stillTime = 0.0f;
+}
+
+void ARope::GatherGeometryBounds(const FBox& region, TArray<FBox>& outBounds) const
+{
+	outBounds.Reset();
+	FCollisionQueryParams queryParams(SCENE_QUERY_STAT(RopeSleep), false, this);
+	TArray<FOverlapResult> overlaps;
+	GetWorld()->OverlapMultiByChannel(overlaps, region.GetCenter(), FQuat::Identity, ECC_Visibility, FCollisionShape::MakeBox(region.GetExtent()), queryParams);
+	INC_ROPE_COUNTER(Traces, 1);
+	for (const FOverlapResult& overlap : overlaps) {
+		if (UPrimitiveComponent* component = overlap.GetComponent()) outBounds.Add(component->Bounds.GetBox());
+	}
+}
+
+void ARope::GeneratePoints(FVector startLocation, FVector endLocation)
+{
+	if (!GetWorld()) return;
+
+	//per-point defaults still come from the rope point class so they stay editable from the blueprint
+	const URopePoint* pointDefaults = GetDefault<URopePoint>();
+	simulation.stiffness = stiffness;
+	simulation.useSimdKernels = useSimdKernels;
+	simulation.solverMode = (useRedBlackSolver) ? ERopeSolverMode::RedBlack : ERopeSolverMode::Sequential;
+	simulation.pointRadius = pointDefaults->radius;
+	simulation.gravitationalAcceleration = FVector3f(pointDefaults->gravitationalAcceleration);
+	//an object the rope drags isn't pinned; RestrainAnchoredObject puts the end back on it every frame
+	simulation.Initialize(startLocation, endLocation, desiredDistanceBetweenPoints, pointDefaults->mass, !anchorIsMovable);
+
+	ropePoints.Empty();
+	for (int i = 0; i < simulation.Num(); ++i) {
+		ropePoints.Emplace(CreateRopePoint(i));
+	}
+
+	//set anchor information; the attachment is kept in the object's own space so it turns with the object
+	anchorLocalOffset = anchorObject->GetActorTransform().InverseTransformPosition(GetAnchorPoint());
+
+	//initialize visual spline
+	splineComponent->ClearSplinePoints();
+	for (int i = 0; i < simulation.Num(); ++i) {
+		splineComponent->AddPoint({ (float)i, simulation.GetPosition(i) }, false);
+		if (!useTubeMesh) ropeMeshes.Add(AcquireSplineMesh());
+	}
+	splineComponent->UpdateSpline();
+	tubeMesh->SetMaterial(0, defaultMaterial);
+	tubeRingCount = 0;
+
+	currentLod = 0;
+	sleeping = false;
+	stillTime = 0.0f;
+	lodSpacing = desiredDistanceBetweenPoints;
+	lodIterationScale = 1.0f;
+	lodTubeSides = tubeSides;
+	offscreenTime = 0.0f;
+
+	timeAccumulator = 0.0f;
+	pendingProjectionTraces.Reset();
+	cornerCache.Reset();
+	wraps.Reset();
+
+	tickInput = FRopeTickInput();
+	tickOutput = FRopeTickOutput();
+	projectedWithDistanceField = false;
+
+	//ropes only tick once they have points to simulate, since pooled ropes sit idle between shots
+	ropeWorld = GetWorld()->GetSubsystem<URopeWorldSubsystem>();
+	if (ropeWorld) ropeWorld->RegisterRope(this);
+	else SetActorTickEnabled(true);
+}
+
+void ARope::Prewarm(int segments)
+{
+	if (!pool) return;
+	for (int i = 0; i < segments; ++i) {
+		pool->ReleaseRopePoint(NewObject<URopePoint>(this));
+		if (!useTubeMesh) pool->ReleaseSplineMesh(CreateSplineMesh());
+	}
+}
+
+void ARope::ReturnToPool(URopePoolSubsystem* owningPool)
+{
+	pool = owningPool;
+	SetActorTickEnabled(false);
+	if (ropeWorld) ropeWorld->UnregisterRope(this);
+	ropeWorld = nullptr;
+
+	for (URopePoint* ropePoint : ropePoints) {
+		ReleaseRopePoint(ropePoint);
+	}
+	for (USplineMeshComponent* splineMesh : ropeMeshes) {
+		ReleaseSplineMesh(splineMesh);
+	}
+	ropePoints.Reset();
+	ropeMeshes.Reset();
+	pendingProjectionTraces.Reset();
+	splineComponent->ClearSplinePoints();
+	tubeMesh->ClearAllMeshSections();
+	tubeRingCount = 0;
+	simulation.Reset();
+
+	anchorObject = nullptr;
+	grappleSource = nullptr;
+	anchorIsMovable = false;
+}
+
+void ARope::StartRecording()
+{
+	//recording starts from the rope exactly as it is, so it can begin part way through a swing
+	if (ropeWorld) ropeWorld->WaitForSimulation();
+	recording = MakeShared<FRopeRecording>();
+	recording->initialState = simulation;
+	recording->initialWraps = wraps;
+	recording->errorAcceptance = errorAcceptance;
+	recording->frames.AddDefaulted();
+}
+
+TSharedPtr<FRopeRecording> ARope::StopRecording()
+{
+	//the open frame hasn't been stepped yet, so it isn't part of the recording
+	TSharedPtr<FRopeRecording> finished = MoveTemp(recording);
+	recording.Reset();
+	if (finished) finished->frames.Pop(false);
+	return finished;
+}
+
+void ARope::BeginReplay(const FRopeRecording& replay)
+{
+	recording.Reset();
+	simulation = replay.initialState;
+	wraps = replay.initialWraps;
+	errorAcceptance = replay.errorAcceptance;
+	cornerCache.Reset();
+	tickInput = FRopeTickInput();
+	tickOutput = FRopeTickOutput();
+}
+
+void ARope::CaptureSnapshot(FRopeSnapshot& outSnapshot) const
+{
+	if (ropeWorld) ropeWorld->WaitForSimulation();
+	outSnapshot.Capture(simulation, wraps, snapshotPrecision);
+}
+
+void ARope::ApplySnapshot(const FRopeSnapshot& snapshot)
+{
+	//a restored rope may be somewhere else entirely, so it wakes and rebuilds everything that followed the old points
+	if (ropeWorld) ropeWorld->WaitForSimulation();
+	snapshot.Apply(simulation, wraps);
+	WakeUp();
+	SyncPointViews();
+}
+
+void ARope::ReplayFrame(const FRopeReplayFrame& frame)
+{
+	//scene queries and the player aren't repeated; their effect on the simulation is replayed as it was recorded
+	for (const FRopeReplayEvent& event : frame.events) {
+		switch (event.type) {
+		case FRopeReplayEvent::EType::Extend:
+			simulation.Extend(event.amount);
+			break;
+		case FRopeReplayEvent::EType::Shorten: {
+			bool removedPoint;
+			simulation.Shorten(event.amount, removedPoint);
+			break;
+		}
+		case FRopeReplayEvent::EType::Resample:
+			simulation.Resample(event.amount);
+			break;
+		case FRopeReplayEvent::EType::Simulate:
+			tickInput = frame.input;
+			Simulate();
+			break;
+		case FRopeReplayEvent::EType::SetPosition:
+			simulation.SetPosition(event.index, event.location);
+			break;
+		case FRopeReplayEvent::EType::ClearVelocities:
+			simulation.ClearVelocities();
+			break;
+		}
+	}
+}
+
+void ARope::RecordEvent(const FRopeReplayEvent& event)
+{
+	if (recording) recording->frames.Last().events.Add(event);
+}
+
+void ARope::RecordFrame()
+{
+	if (!recording) return;
+
+	FRopeReplayFrame& frame = recording->frames.Last();
+	frame.positions.SetNumUninitialized(simulation.Num());
+	for (int i = 0; i < simulation.Num(); ++i) {
+		frame.positions[i] = FVector3f(simulation.GetPosition(i));
+	}
+	recording->frames.AddDefaulted();
+}
+
+void ARope::GatherContacts()
+{
+	projectedWithDistanceField = useDistanceField && UpdateDistanceField();
+	if (projectedWithDistanceField) {
+		ProjectPointsWithDistanceField();
+		return;
+	}
+
+	if (!useAsyncCollision) {
+		GatherNearbyGeometry();
+		FVector previousNormal = FVector::ZeroVector;
+		for (int i = 1; i < simulation.GetTransitionaryInIndex() - 1; ++i) {
+			FVector position = simulation.GetPosition(i);
+			FHitResult outHit;
+			if (IsProjectionCandidate(i)) {
+				SweepPoint(position + (FVector::UpVector * desiredDistanceBetweenPoints / 3), position, simulation.pointRadius, outHit);
+				++pointsTraced;
+			}
+			ResolveProjectionHit(i, outHit, previousNormal);
+		}
+		return;
+	}
+
+	//sweeps issued by the last apply are read back here; if they are still in flight this frame goes without contacts
+	ConsumeAsyncProjection();
+}
+
+bool ARope::UpdateDistanceField()
+{
+	//the field covers everywhere the rope can reach from its anchor, so it is only rebuilt once the rope is reeled past it or the level changes
+	FBox ropeBounds = simulation.GetBounds().ExpandBy(simulation.pointRadius);
+	if (!distanceField.HasRegion() || distanceField.IsStale() || (distanceField.IsReady() && !distanceField.Covers(ropeBounds))) {
+		float reach = GetLength() * simulation.initialGiveMultiplier + desiredDistanceBetweenPoints;
+		FVector anchor = GetAnchorPoint();
+		distanceField.SetRegion(GetWorld(), FBox(anchor - FVector(reach), anchor + FVector(reach)), distanceFieldCellSize, distanceFieldMaxResolution, this);
+	}
+	return distanceField.Build(distanceFieldCellsPerTick) && distanceField.Covers(ropeBounds);
+}
+
+void ARope::ProjectPointsWithDistanceField()
+{
+	GatherNearbyGeometry();
+	FVector previousNormal = FVector::ZeroVector;
+	for (int i = 1; i < simulation.GetTransitionaryInIndex() - 1; ++i) {
+		FVector position = simulation.GetPosition(i);
+		FBox sweepBounds = GetProjectionSweepBounds(position);
+		FHitResult outHit;
+
+		//moving geometry, geometry the field couldn't bake and points already buried in geometry still get a real sweep
+		float distance;
+		FVector gradient;
+		bool sampled = !IsNearGeometry(sweepBounds, nearbyMovableBounds) && !distanceField.IsNearUnsupportedGeometry(sweepBounds) &&
+			distanceField.Sample(position, distance, gradient) && distance > 0 && !gradient.IsNearlyZero();
+		if (sampled) {
+			if (distance < simulation.pointRadius) {
+				outHit.bBlockingHit = true;
+				outHit.ImpactNormal = gradient.GetSafeNormal();
+				outHit.ImpactPoint = position - outHit.ImpactNormal * distance;
+			}
+			ResolveProjectionHit(i, outHit, previousNormal, true);
+			continue;
+		}
+
+		if (IsProjectionCandidate(i)) {
+			SweepPoint(position + (FVector::UpVector * desiredDistanceBetweenPoints / 3), position, simulation.pointRadius, outHit);
+			++pointsTraced;
+		}
+		ResolveProjectionHit(i, outHit, previousNormal);
+	}
+}
+
+void ARope::RequestAsyncProjection()
+{
+	FCollisionQueryParams queryParams(SCENE_QUERY_STAT(RopeProjection), false, this);
+	FCollisionShape sphere = FCollisionShape::MakeSphere(simulation.pointRadius);
+
+	GatherNearbyGeometry();
+	pendingProjectionTraces.Reset();
+	for (int i = 1; i < simulation.GetTransitionaryInIndex() - 1; ++i) {
+		//culled points keep an invalid handle, which reads back as a miss
+		FVector position = simulation.GetPosition(i);
+		if (!IsProjectionCandidate(i)) {
+			pendingProjectionTraces.Add(FTraceHandle());
+			continue;
+		}
+		pendingProjectionTraces.Add(GetWorld()->AsyncSweepByChannel(EAsyncTraceType::Single, position + (FVector::UpVector * desiredDistanceBetweenPoints / 3),
+			position, FQuat::Identity, ECC_Visibility, sphere, queryParams));
+		++pointsTraced;
+		INC_ROPE_COUNTER(Traces, 1);
+	}
+}
+
+void ARope::GatherNearbyGeometry()
+{
+	nearbyGeometryBounds.Reset();
+	nearbyMovableBounds.Reset();
+	if (!useCollisionBroadphase && !useDistanceField) return;
+
+	//one overlap around the whole rope, grown by the projection sweep, finds everything any point's sweep could touch
+	FBox ropeBounds = simulation.GetBounds().ExpandBy(simulation.pointRadius + desiredDistanceBetweenPoints / 3);
+	FCollisionQueryParams queryParams(SCENE_QUERY_STAT(RopeBroadphase), false, this);
+	TArray<FOverlapResult> overlaps;
+	GetWorld()->OverlapMultiByChannel(overlaps, ropeBounds.GetCenter(), FQuat::Identity, ECC_Visibility, FCollisionShape::MakeBox(ropeBounds.GetExtent()), queryParams);
+	INC_ROPE_COUNTER(Traces, 1);
+
+	for (const FOverlapResult& overlap : overlaps) {
+		UPrimitiveComponent* component = overlap.GetComponent();
+		if (!component) continue;
+		nearbyGeometryBounds.Add(component->Bounds.GetBox());
+		if (component->Mobility != EComponentMobility::Static) nearbyMovableBounds.Add(component->Bounds.GetBox());
+	}
+}
+
+bool ARope::IsProjectionCandidate(int ind) const
+{
+	//wrapped points are already pinned to their edge, so there is nothing for a sweep to find
+	if (simulation.HasFlag(ind, ERopePointFlags::Wrapped)) return false;
+	return !useCollisionBroadphase || IsNearGeometry(GetProjectionSweepBounds(simulation.GetPosition(ind)), nearbyGeometryBounds);
+}
+
+bool ARope::IsNearGeometry(const FBox& bounds, const TArray<FBox>& geometryBounds) const
+{
+	for (const FBox& geometry : geometryBounds) {
+		if (bounds.Intersect(geometry)) return true;
+	}
+	return false;
+}
+
+FBox ARope::GetProjectionSweepBounds(const FVector& position) const
+{
+	FBox sweepBounds(position - FVector(simulation.pointRadius), position + FVector(simulation.pointRadius));
+	sweepBounds.Max.Z += desiredDistanceBetweenPoints / 3;
+	return sweepBounds;
+}
+
+bool ARope::ConsumeAsyncProjection()
+{
+	if (pendingProjectionTraces.Num() == 0) return true;
+
+	//every sweep was issued in the same frame, so if the first one issued is still in flight they all are
+	FTraceDatum traceData;
+	UWorld* world = GetWorld();
+	for (const FTraceHandle& handle : pendingProjectionTraces) {
+		if (!handle.IsValid()) continue;
+		if (world->IsTraceHandleValid(handle, false) && !world->QueryTraceData(handle, traceData)) return false;
+		break;
+	}
+
+	FVector previousNormal = FVector::ZeroVector;
+	int lastProjectedIndex = FMath::Min(pendingProjectionTraces.Num(), simulation.GetTransitionaryInIndex() - 2);
+	for (int i = 1; i <= lastProjectedIndex; ++i) {
+		//expired sweeps and points that have since left the swept column are treated as misses rather than snapped back
+		FHitResult outHit;
+		if (world->QueryTraceData(pendingProjectionTraces[i - 1], traceData) && traceData.OutHits.Num() > 0 &&
+			FVector::DistSquared(traceData.End, simulation.GetPosition(i)) <= FMath::Square(desiredDistanceBetweenPoints / 3)) {
+			outHit = traceData.OutHits[0];
+		}
+		ResolveProjectionHit(i, outHit, previousNormal);
+	}
+
+	pendingProjectionTraces.Reset();
+	return true;
+}
+
+void ARope::ResolveProjectionHit(int ind, FHitResult outHit, FVector& previousNormal, bool fromDistanceField)
+{
+	//no new corner is searched for next to an existing wrap
+	if (simulation.HasFlag(ind, ERopePointFlags::Wrapped)) {
+		previousNormal = FVector::ZeroVector;
+		return;
+	}
+
+	if (outHit.bBlockingHit && outHit.ImpactNormal.Z >= (majorityInfluence - 1)) {
+		if (outHit.ImpactNormal.Z < majorityInfluence && !fromDistanceField) {
+			//steep surfaces get a second sweep along their normal; if it misses the original hit is kept
+			FHitResult correctionHit;
+			FVector position = simulation.GetPosition(ind);
+			if (SweepPoint(position + (outHit.ImpactNormal * correctionTraceLength), position, simulation.pointRadius, correctionHit)) outHit = correctionHit;
+		}
+
+		tickInput.contacts.Add({ ind, outHit.ImpactPoint });
+		float angle = FMath::RadiansToDegrees(acosf(FVector::DotProduct(outHit.ImpactNormal, previousNormal)));
+		if (previousNormal != FVector::ZeroVector && angle > 60) {
+			FRopePhaseTimer timer(recordPhaseTimings, phaseTimings.corner);
+			if (fromDistanceField) HandleCornerWithDistanceField(ind - 1, ind, previousNormal, outHit.ImpactNormal);
+			else HandleCorner(ind - 1, ind, previousNormal, outHit.ImpactNormal);
+		}
+		previousNormal = outHit.ImpactNormal;
+	}
+	else if (outHit.bBlockingHit) previousNormal = outHit.ImpactNormal;
+	else previousNormal = FVector::ZeroVector;
+}
+
+bool ARope::SweepPoint(const FVector& start, const FVector& end, float radius, FHitResult& outHit) const
+{
+	FCollisionQueryParams queryParams(SCENE_QUERY_STAT(RopeProjection), false, this);
+	INC_ROPE_COUNTER(Traces, 1);
+	return GetWorld()->SweepSingleByChannel(outHit, start, end, FQuat::Identity, ECC_Visibility, FCollisionShape::MakeSphere(radius), queryParams);
+}
+
+void ARope::ProjectPoint(int ind, FVector impactPoint, bool groundCollision)
+{
+	float correctionWeight = (groundCollision) ? 0.9 : 0.7;
+	FVector previousPosition = simulation.GetPreviousPosition(ind);
+	FVector correctedPrevPos = previousPosition + (impactPoint - previousPosition) * correctionWeight;
+	simulation.SetPreviousPosition(ind, FVector(correctedPrevPos.X, correctedPrevPos.Y, previousPosition.Z));
+
+	FVector position = impactPoint;
+	if (!groundCollision) position.Z = previousPosition.Z;
+	simulation.SetPosition(ind, position);
+
+	simulation.AddResolvedCollisions(ind, 2);
+}
+
+void ARope::HandleCorner(int indA, int indB, FVector aImpactNormal, FVector bImpactNormal)
+{
+	SCOPE_ROPE_CYCLE_COUNTER(HandleCorner);
+
+	//a rope resting over the same ledge finds the same corner every step, so corners are kept per segment until the contact changes
+	if (cornerCache.Num() < simulation.Num()) cornerCache.SetNum(simulation.Num());
+	FRopeCorner& cached = cornerCache[indA];
+	if (!IsCachedCornerUsable(cached, indA, indB, aImpactNormal, bImpactNormal)) {
+		FVector corner;
+		if (!LocateCorner(indA, indB, aImpactNormal, bImpactNormal, corner)) {
+			cached.valid = false;
+			return;
+		}
+		cached = { corner, aImpactNormal, bImpactNormal, true };
+	}
+
+	int modifiedInd = (FVector::Distance(cached.location, simulation.GetPosition(indA)) < FVector::Distance(cached.location, simulation.GetPosition(indB))) ? indA : indB;
+	QueueWrap(modifiedInd, cached.location, aImpactNormal, bImpactNormal);
+}
+
+bool ARope::IsCachedCornerUsable(const FRopeCorner& cached, int indA, int indB, const FVector& aImpactNormal, const FVector& bImpactNormal) const
+{
+	if (!cached.valid) return false;
+	if (FVector::DotProduct(cached.aNormal, aImpactNormal) < cornerCacheNormalTolerance || FVector::DotProduct(cached.bNormal, bImpactNormal) < cornerCacheNormalTolerance) return false;
+
+	//the corner has to still sit along the segment it was found for
+	FVector closest = FMath::ClosestPointOnSegment(cached.location, simulation.GetPosition(indA), simulation.GetPosition(indB));
+	return FVector::DistSquared(closest, cached.location) <= FMath::Square(simulation.GetDistanceBetweenPoints());
+}
+
+bool ARope::LocateCorner(int indA, int indB, const FVector& aImpactNormal, const FVector& bImpactNormal, FVector& outCorner)
+{
+	//walking out from B along A's normal, face B ends where it meets face A's plane; that offset brackets the search
+	FVector origin = simulation.GetPosition(indB);
+	float estimate = FMath::Clamp(FVector::DotProduct(simulation.GetPosition(indA) - origin, aImpactNormal), 0.0f, cornerSearchDistance);
+	float margin = desiredDistanceBetweenPoints / 5;
+	float hitOffset = FMath::Max(0.0f, estimate - margin);
+	float missOffset = FMath::Min(cornerSearchDistance, estimate + margin);
+
+	FVector lastHit;
+	if (!ProbeCorner(origin, hitOffset, aImpactNormal, bImpactNormal, lastHit)) {
+		hitOffset = 0.0f;
+		if (!ProbeCorner(origin, hitOffset, aImpactNormal, bImpactNormal, lastHit)) return false;
+	}
+	FVector ignored;
+	if (ProbeCorner(origin, missOffset, aImpactNormal, bImpactNormal, ignored)) {
+		//face B kept going past the estimate, so widen to the full search distance before giving up on a corner
+		hitOffset = missOffset;
+		lastHit = ignored;
+		missOffset = cornerSearchDistance;
+		if (ProbeCorner(origin, missOffset, aImpactNormal, bImpactNormal, ignored)) return false;
+	}
+
+	while (missOffset - hitOffset > cornerSearchTolerance) {
+		float middle = (hitOffset + missOffset) * 0.5f;
+		if (ProbeCorner(origin, middle, aImpactNormal, bImpactNormal, lastHit)) hitOffset = middle;
+		else missOffset = middle;
+	}
+
+	outCorner = lastHit;
+	return true;
+}
+
+bool ARope::ProbeCorner(const FVector& origin, float offset, const FVector& aImpactNormal, const FVector& bImpactNormal, FVector& outImpactPoint) const
+{
+	FVector probe = origin + aImpactNormal * offset;
+	FHitResult outHit;
+	if (!SweepPoint(probe + (bImpactNormal * correctionTraceLength), probe, 10, outHit)) return false;
+	outImpactPoint = outHit.ImpactPoint;
+	return true;
+}
+
+void ARope::HandleCornerWithDistanceField(int indA, int indB, FVector aImpactNormal, FVector bImpactNormal)
+{
+	SCOPE_ROPE_CYCLE_COUNTER(HandleCorner);
+
+	//the field's normal swings from one face's normal to the other's across the edge, so bisect for where it is halfway round
+	FVector low = simulation.GetPosition(indA);
+	FVector high = simulation.GetPosition(indB);
+	float distance;
+	FVector gradient;
+	for (int i = 0; i < cornerBisectionSteps; ++i) {
+		FVector middle = (low + high) * 0.5f;
+		if (!distanceField.Sample(middle, distance, gradient)) return;
+		if (FVector::DotProduct(gradient, aImpactNormal) >= FVector::DotProduct(gradient, bImpactNormal)) low = middle;
+		else high = middle;
+	}
+
+	FVector corner = (low + high) * 0.5f;
+	if (!distanceField.Sample(corner, distance, gradient) || gradient.IsNearlyZero()) return;
+	corner -= gradient.GetSafeNormal() * distance;
+
+	int modifiedInd = (FVector::Distance(corner, simulation.GetPosition(indA)) < FVector::Distance(corner, simulation.GetPosition(indB))) ? indA : indB;
+	QueueWrap(modifiedInd, corner, aImpactNormal, bImpactNormal);
+}
+
+void ARope::QueueWrap(int ind, const FVector& location, const FVector& aImpactNormal, const FVector& bImpactNormal)
+{
+	//corners are found during the gather, but the simulation only changes in the simulate stage
+	tickInput.newWraps.Add({ ind, location, (aImpactNormal + bImpactNormal).GetSafeNormal() });
+}
+
+void ARope::WrapPoint(const FRopeWrap& wrap)
+{
+	//neighbouring pairs can both find a corner at the point between them, and a point is only ever pinned to one edge;
+	//a second wrap would share the first one's flag, and releasing either would leave the other behind unpinned
+	if (simulation.HasFlag(wrap.index, ERopePointFlags::Wrapped)) return;
+
+	//the point stays pinned on the edge with no velocity until the rope pulls away from it
+	simulation.SetPosition(wrap.index, wrap.location);
+	simulation.SetPreviousPosition(wrap.index, wrap.location);
+	simulation.SetFlag(wrap.index, ERopePointFlags::Wrapped);
+	wraps.Add(wrap);
+}
+
+void ARope::ReleaseUnwrappedPoints()
+{
+	for (int w = wraps.Num() - 1; w >= 0; --w) {
+		const FRopeWrap& wrap = wraps[w];
+
+		//reeling can move the transitionary points onto a wrap, and those are never pinned
+		bool release = wrap.index <= 0 || wrap.index >= simulation.GetTransitionaryInIndex() - 1;
+		if (!release) {
+			//the rope only presses on the edge while the pull from both neighbours points into it
+			FVector towardHeld = (simulation.GetPosition(wrap.index - 1) - wrap.location).GetSafeNormal();
+			FVector towardAnchor = (simulation.GetPosition(wrap.index + 1) - wrap.location).GetSafeNormal();
+			release = FVector::DotProduct(towardHeld + towardAnchor, wrap.edgeNormal) >= 0;
+		}
+
+		if (release) {
+			if (wrap.index < simulation.Num()) simulation.SetFlag(wrap.index, ERopePointFlags::Wrapped, false);
+			wraps.RemoveAtSwap(w, 1, false);
+		}
+	}
+}
+
+int ARope::GetPivotIndex() const
+{
+	int pivotIndex = simulation.GetAnchorIndex();
+	for (const FRopeWrap& wrap : wraps) {
+		pivotIndex = FMath::Min(pivotIndex, wrap.index);
+	}
+	return pivotIndex;
+}
+
+float ARope::GetFreeLength(int pivotIndex) const
+{
+	//the share of the rope between the held point and the pivot, keeping the rope's give
+	float restLength = simulation.GetRestLengthTo(simulation.GetAnchorIndex());
+	return (restLength > 0) ? simulation.GetLength() * simulation.GetRestLengthTo(pivotIndex) / restLength : simulation.GetLength();
+}
+
+void ARope::SimulateAnchoredObject()
+{
+	//the object simulates its own physics; the rope end starts each frame wherever the physics solve left it
+	simulation.SetPosition(simulation.GetAnchorIndex(), GetAnchorObjectPoint());
+	RecordEvent({ FRopeReplayEvent::EType::SetPosition, simulation.GetAnchorIndex(), 0.0f, GetAnchorPoint() });
+}
+
+void ARope::RestrainAnchoredObject()
+{
+	SCOPE_ROPE_CYCLE_COUNTER(RestrainAnchoredObject);
+	FRopePhaseTimer timer(recordPhaseTimings, phaseTimings.restrain);
+	FVector anchorPoint = GetAnchorObjectPoint();
+	simulation.SetPosition(simulation.GetAnchorIndex(), anchorPoint);
+
+	//replicated objects are pulled by the server's rope only; other machines see the result through physics replication
+	if (!anchorBody || !anchorBody->IsSimulatingPhysics() || !anchorObject->HasAuthority()) return;
+
+	//the rope only pulls, and only once it's taut
+	FVector fromHeld = anchorPoint - GetHeldPoint();
+	float distance = fromHeld.Size();
+	float maxLength = GetLength() * simulation.initialGiveMultiplier;
+	if (distance <= maxLength) return;
+
+	//an impulse along the rope stops the attachment moving away from the held point and takes back part of the overstretch;
+	//it is sized by the body's effective mass at the attachment, so a heavy object gives way less than a light one
+	float deltaTime = tickOutput.substeps * tickOutput.stepTime;
+	FVector direction = fromHeld / distance;
+	FVector heldVelocity = (grappleSource->GetOwner()) ? grappleSource->GetOwner()->GetVelocity() : FVector::ZeroVector;
+	float separatingSpeed = FVector::DotProduct(anchorBody->GetPhysicsLinearVelocityAtPoint(anchorPoint) - heldVelocity, direction);
+	float targetSpeed = -(distance - maxLength) * pullStiffness / deltaTime;
+	if (separatingSpeed <= targetSpeed) return;
+
+	//the rope is only as strong as maxPullForce, which is what leaves objects too heavy to drag where they are
+	float impulse = FMath::Min((separatingSpeed - targetSpeed) / GetAnchorBodyInverseMass(anchorPoint, direction), maxPullForce * deltaTime);
+	anchorBody->AddImpulseAtLocation(-direction * impulse, anchorPoint);
+}
+
+float ARope::GetAnchorBodyInverseMass(const FVector& point, const FVector& direction) const
+{
+	//a pull off the centre of mass turns the body as well as moving it, so less of it goes into moving the attachment along the rope
+	const FBodyInstance* body = anchorBody->GetBodyInstance();
+	float inverseMass = 1.0f / FMath::Max(body->GetBodyMass(), KINDA_SMALL_NUMBER);
+	FTransform massFrame = body->GetMassSpaceLocal() * body->GetUnrealWorldTransform();
+	FVector arm = massFrame.InverseTransformVectorNoScale(FVector::CrossProduct(point - body->GetCOMPosition(), direction));
+	FVector inertia = body->GetBodyInertiaTensor();
+	for (int axis = 0; axis < 3; ++axis) {
+		if (inertia[axis] > KINDA_SMALL_NUMBER) inverseMass += FMath::Square(arm[axis]) / inertia[axis];
+	}
+	return inverseMass;
+}
+
+USplineMeshComponent* ARope::CreateSplineMesh()
+{
+	USplineMeshComponent* splineMesh = NewObject<USplineMeshComponent>(this, USplineMeshComponent::StaticClass());
+	INC_ROPE_COUNTER(ObjectsCreated, 1);
+	splineMesh->SetStaticMesh(mesh);
+	splineMesh->SetForwardAxis(ESplineMeshAxis::Z, true);
+	splineMesh->RegisterComponentWithWorld(GetWorld());
+	splineMesh->SetMobility(EComponentMobility::Movable);
+	splineMesh->AttachToComponent(splineComponent, FAttachmentTransformRules::KeepRelativeTransform);
+	return splineMesh;
+}
+
+USplineMeshComponent* ARope::AcquireSplineMesh()
+{
+	USplineMeshComponent* splineMesh = (pool) ? pool->AcquireSplineMesh() : nullptr;
+	if (!splineMesh) return CreateSplineMesh();
+
+	//pooled meshes may have been built by another rope, so they move over to ours and are registered as our component;
+	//left on the rope that built them, they would go with it if it were destroyed while we were still drawing with them
+	if (splineMesh->GetOwner() != this) {
+		splineMesh->UnregisterComponent();
+		splineMesh->Rename(nullptr, this, REN_DontCreateRedirectors | REN_NonTransactional | REN_DoNotDirty);
+		splineMesh->RegisterComponentWithWorld(GetWorld());
+	}
+	splineMesh->SetStaticMesh(mesh);
+	if (splineMesh->GetAttachParent() != splineComponent) splineMesh->AttachToComponent(splineComponent, FAttachmentTransformRules::KeepRelativeTransform);
+	return splineMesh;
+}
+
+void ARope::ReleaseSplineMesh(USplineMeshComponent* splineMesh)
+{
+	if (pool) pool->ReleaseSplineMesh(splineMesh);
+	else {
+		splineMesh->DestroyComponent();
+		INC_ROPE_COUNTER(ObjectsDestroyed, 1);
+	}
+}
+
+URopePoint* ARope::CreateRopePoint(int ind)
+{
+	URopePoint* ropePoint = (pool) ? pool->AcquireRopePoint() : nullptr;
+	if (!ropePoint) {
+		ropePoint = NewObject<URopePoint>(this);
+		INC_ROPE_COUNTER(ObjectsCreated, 1);
+	}
+	else if (ropePoint->GetOuter() != this) ropePoint->Rename(nullptr, this, REN_DontCreateRedirectors | REN_NonTransactional | REN_DoNotDirty);
+	ropePoint->Bind(&simulation, ind);
+	return ropePoint;
+}
+
+void ARope::ReleaseRopePoint(URopePoint* ropePoint)
+{
+	//without a pool the point is simply dropped for garbage collection
+	ropePoint->Bind(nullptr, INDEX_NONE);
+	if (pool) pool->ReleaseRopePoint(ropePoint);
+	else INC_ROPE_COUNTER(ObjectsDestroyed, 1);
+}
+
+void ARope::GenerateLine(float interpolationAlpha)
+{
+	SCOPE_ROPE_CYCLE_COUNTER(GenerateLine);
+	FRopePhaseTimer timer(recordPhaseTimings, phaseTimings.renderPrep);
+	/*FColor color; float adjust;
+	for (int i = 0; i < simulation.Num(); ++i) {
+		color = (i == simulation.GetTransitionaryOutIndex()) ? FColor::Red : (i == simulation.GetTransitionaryInIndex()) ? FColor::Yellow : FColor::Blue;
+		if (simulation.HasFlag(i, ERopePointFlags::Wrapped)) color = FColor::Purple;
+		adjust = (i == simulation.GetTransitionaryOutIndex()) ? 0.75f : 1.0f;
+		DrawDebugSphere(GetWorld(), simulation.GetPosition(i), simulation.pointRadius * adjust, 16, color, false, 0);
+	}*/
+
+	//render prep is a single pass over the points in the spline's space, which the tube and segment meshes share
+	const FTransform& toWorld = splineComponent->GetComponentTransform();
+	int pointCount = simulation.Num();
+	linePoints.SetNumUninitialized(pointCount, false);
+	for (int i = 0; i < pointCount; ++i) {
+		linePoints[i] = toWorld.InverseTransformPosition(simulation.GetInterpolatedPosition(i, interpolationAlpha));
+	}
+
+	//the spline itself is only kept in step when something reads it, and then reparameterised once rather than per point
+	if (keepSplineUpdated || splineComponent->bDrawDebug) {
+		for (int i = 0; i < pointCount; ++i) {
+			splineComponent->SetLocationAtSplinePoint(i, linePoints[i], ESplineCoordinateSpace::Local, false);
+		}
+		splineComponent->UpdateSpline();
+	}
+
+	//the drawn rope starts at the gun rather than at the held point
+	if (pointCount < 2) return;
+	linePoints[0] = toWorld.InverseTransformPosition(grappleSource->GetRopeOrigin());
+
+	if (useTubeMesh) {
+		UpdateTubeMesh();
+		return;
+	}
+
+	for (int i = 0; i < pointCount - 1; ++i) {
+		ropeMeshes[i]->SetStartAndEnd(linePoints[i], GetLineTangent(i), linePoints[i + 1], GetLineTangent(i + 1), true);
+	}
+}
+
+FVector ARope::GetLineTangent(int ind) const
+{
+	//the same Catmull-Rom tangents the spline would auto-compute for evenly keyed points, clamped at the ends
+	int last = linePoints.Num() - 1;
+	FVector difference = linePoints[FMath::Min(ind + 1, last)] - linePoints[FMath::Max(ind - 1, 0)];
+	return (ind == 0 || ind == last) ? difference : difference * 0.5f;
+}
+
+void ARope::UpdateTubeMesh()
+{
+	int ringCount = linePoints.Num();
+	int sides = FMath::Max(3, lodTubeSides);
+	int ringSize = sides + 1;
+	tubeVertices.SetNumUninitialized(ringCount * ringSize, false);
+	tubeNormals.SetNumUninitialized(ringCount * ringSize, false);
+	tubeUVs.SetNumUninitialized(ringCount * ringSize, false);
+	tubeTangents.SetNumUninitialized(ringCount * ringSize, false);
+
+	FVector side = FVector::ZeroVector;
+	float distanceAlong = 0.0f;
+	for (int i = 0; i < ringCount; ++i) {
+		FVector direction = GetLineTangent(i).GetSafeNormal();
+		if (direction.IsNearlyZero()) direction = FVector::UpVector;
+
+		//carry the previous ring's side vector along the rope so the tube doesn't twist between rings
+		side = (side - direction * FVector::DotProduct(side, direction)).GetSafeNormal();
+		if (side.IsNearlyZero()) side = FVector::CrossProduct(direction, (FMath::Abs(direction.Z) < 0.9f) ? FVector::UpVector : FVector::ForwardVector).GetSafeNormal();
+		FVector up = FVector::CrossProduct(direction, side);
+
+		//texture repeats once per circumference of length so it keeps its aspect as the rope stretches
+		if (i > 0) distanceAlong += FVector::Distance(linePoints[i - 1], linePoints[i]);
+		float v = distanceAlong / (2 * PI * tubeRadius);
+		for (int s = 0; s < ringSize; ++s) {
+			float angle = 2 * PI * s / sides;
+			FVector normal = side * FMath::Cos(angle) + up * FMath::Sin(angle);
+			int vertex = i * ringSize + s;
+			tubeVertices[vertex] = linePoints[i] + normal * tubeRadius;
+			tubeNormals[vertex] = normal;
+			tubeUVs[vertex] = FVector2D((float)s / sides, v);
+			tubeTangents[vertex] = FProcMeshTangent(direction, false);
+		}
+	}
+
+	//topology only changes when the rope gains or loses a point; every other frame just streams new vertices
+	if (tubeRingCount == ringCount && tubeSidesBuilt == sides) {
+		tubeMesh->UpdateMeshSection(0, tubeVertices, tubeNormals, tubeUVs, TArray<FColor>(), tubeTangents);
+		return;
+	}
+
+	tubeTriangles.Reset();
+	for (int i = 0; i < ringCount - 1; ++i) {
+		for (int s = 0; s < sides; ++s) {
+			int a = i * ringSize + s;
+			int c = a + ringSize;
+			tubeTriangles.Append({ a, a + 1, c, a + 1, c + 1, c });
+		}
+	}
+	tubeMesh->CreateMeshSection(0, tubeVertices, tubeTriangles, tubeNormals, tubeUVs, TArray<FColor>(), tubeTangents, false);
+	tubeRingCount = ringCount;
+	tubeSidesBuilt = sides;
+}
+
+bool ARope::Shorten(float rateOfChange)
+{
+	//reeling changes the point count, so it can't overlap a simulate stage still running on a worker
+	if (ropeWorld) ropeWorld->WaitForSimulation();
+	WakeUp();
+	RecordEvent({ FRopeReplayEvent::EType::Shorten, INDEX_NONE, rateOfChange });
+	bool removedPoint;
+	if (!simulation.Shorten(rateOfChange, removedPoint)) return false;
+
+	//the simulation only ever drops its last slot, so the views, meshes and spline shrink from the end as well
+	if (removedPoint) {
+		ReleaseRopePoint(ropePoints.Pop(false));
+		if (!useTubeMesh) ReleaseSplineMesh(ropeMeshes.Pop(false));
+		splineComponent->RemoveSplinePoint(splineComponent->GetNumberOfSplinePoints() - 1, false);
+	}
+
+	return true;
+}
+
+void ARope::Extend(float rateOfChange)
+{
+	if (ropeWorld) ropeWorld->WaitForSimulation();
+	WakeUp();
+	RecordEvent({ FRopeReplayEvent::EType::Extend, INDEX_NONE, rateOfChange });
+	if (simulation.Extend(rateOfChange)) {
+		int anchorIndex = simulation.GetAnchorIndex();
+		ropePoints.Emplace(CreateRopePoint(anchorIndex));
+		if (!useTubeMesh) ropeMeshes.Emplace(AcquireSplineMesh());
+		splineComponent->AddSplinePoint(simulation.GetPosition(anchorIndex), ESplineCoordinateSpace::World, false);
+	}
+}
\ No newline at end of file
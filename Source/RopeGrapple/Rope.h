@@ -1,93 +1,340 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/Actor.h"
-#include "RopePoint.h"
-#include "DrawDebugHelpers.h"
-#include "Kismet/KismetSystemLibrary.h"
-#include "Components/LineBatchComponent.h"
-#include "Components/SplineComponent.h"
-#include "Components/SplineMeshComponent.h"
-#include "Rope.generated.h"
-
-UCLASS()
-class ROPEGRAPPLE_API ARope : public AActor
-{
-	GENERATED_BODY()
-	
-public:	
-	ARope();
-	virtual void Tick(float DeltaTime) override;
-	void GeneratePoints(FVector startLocation, FVector endLocation);
-	void GenerateLine();
-
-	void Extend(float rateOfChange);
-	bool Shorten(float rateOfChange);
-
-	void SetObjectLocks(AActor* anchor, class UGrappleGun* ropeSource, bool anchorCanMove = false) { anchorObject = anchor; grappleSource = ropeSource; anchorIsMovable = anchorCanMove; anchorObjectPosition = previousAnchorObjectPosition = anchorObject->GetActorLocation();}
-	float GetLength() { return ropeLength + transitionaryOutDistance - (realDistanceBetweenPoints - transitionaryInDistance); };
-	float GetInitialGiveMultiplier() { return initialGiveMultiplier; };
-	FVector GetHeldPoint() { return ropePoints[0]->position; };
-	FVector GetAnchorPoint() { return ropePoints[ropePoints.Num() - 1]->position; };
-	void SetAnchorNormal(FVector normal) { anchorNormal = normal; };
-	FVector GetAnchorNormal() { return anchorNormal; };
-	bool IsAnchorMovable() { return anchorIsMovable; };
-	bool GreaterThanRopeLength(FVector comparisonVector) { ropeTempLength = GetLength() * initialGiveMultiplier; return comparisonVector.SquaredLength() >= ropeTempLength * ropeTempLength; };
-	void SetMeshAndMaterial(UStaticMesh* mesh_, UMaterialInterface* material_) { mesh = mesh_; defaultMaterial = material_; };
-
-protected:
-	virtual void BeginPlay() override;
-	void RestrainPoints(int iterations);
-	void ProjectPoints();
-	void ProjectPoint(int ind, FVector impactPoint, bool zCorrectionAllowed = true);
-	void HandleCorner(int indA, int indB, FVector aImpactNormal, FVector bImpactNormal);
-	void Constrain(int indA, int indB, float constraintDist);
-	void SimulateAnchoredObject(float DeltaTime);
-	void RestrainAnchoredObject();
-	USplineMeshComponent* CreateSplineMesh();
-
-	UPROPERTY(VisibleAnywhere, Category = "Grapple Options")
-		int constraintIterations = 100;
-	UPROPERTY(VisibleAnywhere, Category = "Grapple Options")
-		float desiredDistanceBetweenPoints = 50.0f;
-	UPROPERTY(VisibleAnywhere, Category = "Grapple Options")
-		float stiffness = 0.93f;
-	UPROPERTY(VisibleAnywhere, Category = "Grapple Options")
-		float playerCausedTension = 50.0f;
-	UPROPERTY(VisibleAnywhere, Category = "Grapple Options")
-		TArray<URopePoint*> ropePoints;
-	UPROPERTY(VisibleAnywhere, Category = "Grapple Options")
-		USplineComponent* splineComponent;
-	UPROPERTY(VisibleAnywhere, Category = "Grapple Options")
-		TArray<USplineMeshComponent*> ropeMeshes;
-
-	AActor* anchorObject;
-	class UGrappleGun* grappleSource;
-	FVector anchorNormal;
-	float realDistanceBetweenPoints;
-	float realStiffness;
-	float ropeLength;
-	float initialGiveMultiplier = 1.05f;
-
-	int transitionaryOutIndex = -1;
-	int transitionaryInIndex = -1;
-	float transitionaryOutDistance = 0.1f;
-	float transitionaryInDistance = 0.0f;
-	float errorAcceptance = 0.01f;
-	float correctionTraceLength = 100.0f;
-	float majorityInfluence = 0.75f;
-	float minorityInfluence = 0.4f;
-	float outlierMultiplier = 10.0f;
-
-	FVector anchorObjectPosition;
-	FVector previousAnchorObjectPosition;
-	float ropeTempLength;
-
-	bool anchorIsMovable;
-	FVector anchorObjectImpactOffset;
-
-	UStaticMesh* mesh;
-	class UMaterialInterface* defaultMaterial;
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "RopePoint.h"
+#include "DrawDebugHelpers.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "Components/LineBatchComponent.h"
+#include "Components/SplineComponent.h"
+#include "Components/SplineMeshComponent.h"
+#include "ProceduralMeshComponent.h"
+#include "WorldCollision.h"
+#include "RopeDistanceField.h"
+#include "Rope.generated.h"
+
+//a corner found between two neighbouring points, kept so later steps can reuse it while the rope rests on the same edge
+struct FRopeCorner
+{
+	FVector location;
+	FVector aNormal;
+	FVector bNormal;
+	bool valid = false;
+};
+
+//an edge the rope is wrapped over; the point at index stays pinned there until the rope pulls away from the edge
+struct FRopeWrap
+{
+	int index;
+	FVector location;
+	FVector edgeNormal;
+};
+
+//a point found resting on a surface when the frame was gathered; the frame's first substep presses it back onto the surface
+struct FRopeContact
+{
+	int index;
+	FVector impactPoint;
+};
+
+//cycles spent in each part of a rope's frame, only collected while something like a benchmark asks for them
+struct FRopePhaseTimings
+{
+	uint64 integrate = 0;
+	uint64 constrain = 0;
+	uint64 project = 0;
+	uint64 corner = 0;
+	uint64 renderPrep = 0;
+	uint64 restrain = 0;
+};
+
+//one level of rope detail; the first level is full detail and each later one is used further from every camera
+USTRUCT(BlueprintType)
+struct FRopeLodLevel
+{
+	GENERATED_BODY()
+
+	FRopeLodLevel() = default;
+	FRopeLodLevel(float distance_, float spacingMultiplier_, float iterationScale_, bool projectPoints_, int tubeSides_) :
+		distance(distance_), spacingMultiplier(spacingMultiplier_), iterationScale(iterationScale_), projectPoints(projectPoints_), tubeSides(tubeSides_) {};
+
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float distance = 0.0f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float spacingMultiplier = 1.0f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float iterationScale = 1.0f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		bool projectPoints = true;
+	//zero keeps the rope's own tube side count
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		int tubeSides = 0;
+};
+
+//everything the simulate stage reads from the world, copied on the game thread before the stage starts
+struct FRopeTickInput
+{
+	int substeps = 0;
+	float stepTime = 0.0f;
+	int minIterations = 0;
+	int maxIterations = 0;
+	bool projectPoints = true;
+	FVector heldPosition = FVector::ZeroVector;
+	TArray<FRopeContact> contacts;
+	TArray<FRopeWrap> newWraps;
+};
+
+//everything the simulate stage hands back, applied to the world on the game thread once the stage has finished
+struct FRopeTickOutput
+{
+	int substeps = 0;
+	float stepTime = 0.0f;
+	int iterationsUsed = 0;
+	float finalResidual = 0.0f;
+};
+
+struct FRopeRecording;
+struct FRopeReplayFrame;
+struct FRopeReplayEvent;
+struct FRopeSnapshot;
+
+UCLASS()
+class ROPEGRAPPLE_API ARope : public AActor
+{
+	GENERATED_BODY()
+	
+public:	
+	ARope();
+	virtual void Tick(float DeltaTime) override;
+	int GatherInput(float DeltaTime);
+	void Simulate();
+	void ApplyOutput();
+	void GeneratePoints(FVector startLocation, FVector endLocation);
+	void GenerateLine(float interpolationAlpha = 1.0f);
+
+	void Extend(float rateOfChange);
+	bool Shorten(float rateOfChange);
+	void WakeUp();
+	bool IsSleeping() const { return sleeping; };
+	void SetAllowSleep(bool allow) { allowSleep = allow; if (!allow) WakeUp(); };
+	void SetRecordPhaseTimings(bool record) { recordPhaseTimings = record; phaseTimings = FRopePhaseTimings(); };
+	const FRopePhaseTimings& GetPhaseTimings() const { return phaseTimings; };
+	int GetPointCount() const { return simulation.Num(); };
+	const FRopeSimulation& GetSimulation() const { return simulation; };
+	void StartRecording();
+	TSharedPtr<FRopeRecording> StopRecording();
+	bool IsRecording() const { return recording.IsValid(); };
+	void BeginReplay(const FRopeRecording& replay);
+	void ReplayFrame(const FRopeReplayFrame& frame);
+	void CaptureSnapshot(FRopeSnapshot& outSnapshot) const;
+	void ApplySnapshot(const FRopeSnapshot& snapshot);
+
+	void SetObjectLocks(AActor* anchor, class UGrappleGun* ropeSource, bool anchorCanMove = false) { anchorObject = anchor; grappleSource = ropeSource; anchorIsMovable = anchorCanMove; anchorBody = Cast<UPrimitiveComponent>(anchorObject->GetRootComponent()); };
+	AActor* GetAnchorObject() const { return anchorObject; };
+	float GetLength() { return simulation.GetLength(); };
+	float GetInitialGiveMultiplier() { return simulation.initialGiveMultiplier; };
+	FVector GetHeldPoint() { return simulation.GetPosition(0); };
+	FVector GetAnchorPoint() { return simulation.GetPosition(simulation.GetAnchorIndex()); };
+	void SetAnchorNormal(FVector normal) { anchorNormal = normal; };
+	FVector GetAnchorNormal() { return anchorNormal; };
+	int GetIterationsUsed() { return iterationsUsed; };
+	float GetFinalResidual() { return finalResidual; };
+	int GetMinConstraintIterations() const { return minConstraintIterations; };
+	int GetMaxConstraintIterations() const { return maxConstraintIterations; };
+	float GetErrorAcceptance() const { return errorAcceptance; };
+	bool IsAnchorMovable() { return anchorIsMovable; };
+	bool GreaterThanRopeLength(FVector comparisonVector) { ropeTempLength = GetLength() * simulation.initialGiveMultiplier; return comparisonVector.SquaredLength() >= ropeTempLength * ropeTempLength; };
+	void SetMeshAndMaterial(UStaticMesh* mesh_, UMaterialInterface* material_) { mesh = mesh_; defaultMaterial = material_; };
+	void SetPool(class URopePoolSubsystem* pool_) { pool = pool_; };
+	void Prewarm(int segments);
+	void ReturnToPool(class URopePoolSubsystem* owningPool);
+
+protected:
+	friend class FRopeAdjacentCornerWrapTest;
+
+	virtual void BeginPlay() override;
+	void UpdateLod(float DeltaTime);
+	bool GetNearestViewDistance(float& outDistance) const;
+	void ResampleRope(float spacing);
+	void SyncPointViews();
+	void UpdateSleep();
+	bool ShouldWake(float DeltaTime);
+	void GatherGeometryBounds(const FBox& region, TArray<FBox>& outBounds) const;
+	void GatherContacts();
+	bool UpdateDistanceField();
+	void ProjectPointsWithDistanceField();
+	void GatherNearbyGeometry();
+	bool IsProjectionCandidate(int ind) const;
+	bool IsNearGeometry(const FBox& bounds, const TArray<FBox>& geometryBounds) const;
+	FBox GetProjectionSweepBounds(const FVector& position) const;
+	void RequestAsyncProjection();
+	bool ConsumeAsyncProjection();
+	void ResolveProjectionHit(int ind, FHitResult outHit, FVector& previousNormal, bool fromDistanceField = false);
+	bool SweepPoint(const FVector& start, const FVector& end, float radius, FHitResult& outHit) const;
+	void ProjectPoint(int ind, FVector impactPoint, bool zCorrectionAllowed = true);
+	void HandleCorner(int indA, int indB, FVector aImpactNormal, FVector bImpactNormal);
+	bool IsCachedCornerUsable(const FRopeCorner& cached, int indA, int indB, const FVector& aImpactNormal, const FVector& bImpactNormal) const;
+	bool LocateCorner(int indA, int indB, const FVector& aImpactNormal, const FVector& bImpactNormal, FVector& outCorner);
+	bool ProbeCorner(const FVector& origin, float offset, const FVector& aImpactNormal, const FVector& bImpactNormal, FVector& outImpactPoint) const;
+	void HandleCornerWithDistanceField(int indA, int indB, FVector aImpactNormal, FVector bImpactNormal);
+	void QueueWrap(int ind, const FVector& location, const FVector& aImpactNormal, const FVector& bImpactNormal);
+	void WrapPoint(const FRopeWrap& wrap);
+	void ReleaseUnwrappedPoints();
+	int GetPivotIndex() const;
+	float GetFreeLength(int pivotIndex) const;
+	void SimulateAnchoredObject();
+	void RestrainAnchoredObject();
+	FVector GetAnchorObjectPoint() const { return anchorObject->GetActorTransform().TransformPosition(anchorLocalOffset); };
+	float GetAnchorBodyInverseMass(const FVector& point, const FVector& direction) const;
+	USplineMeshComponent* CreateSplineMesh();
+	USplineMeshComponent* AcquireSplineMesh();
+	void ReleaseSplineMesh(USplineMeshComponent* splineMesh);
+	FVector GetLineTangent(int ind) const;
+	void UpdateTubeMesh();
+	URopePoint* CreateRopePoint(int ind);
+	void ReleaseRopePoint(URopePoint* ropePoint);
+	void RecordEvent(const FRopeReplayEvent& event);
+	void RecordFrame();
+
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		int minConstraintIterations = 6;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		int maxConstraintIterations = 100;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float errorAcceptance = 0.01f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options", meta = (ClampMin = "0.001"))
+		float snapshotPrecision = 0.1f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options", meta = (ClampMin = "0.001"))
+		float fixedTimeStep = 1.0f / 60.0f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options", meta = (ClampMin = "1"))
+		int maxSubstepsPerFrame = 4;
+	UPROPERTY(VisibleAnywhere, Category = "Grapple Options")
+		float desiredDistanceBetweenPoints = 50.0f;
+	UPROPERTY(VisibleAnywhere, Category = "Grapple Options")
+		float stiffness = 0.93f;
+	UPROPERTY(VisibleAnywhere, Category = "Grapple Options")
+		float playerCausedTension = 50.0f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		bool useSimdKernels = true;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		bool useRedBlackSolver = false;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		bool useAsyncCollision = true;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		bool useCollisionBroadphase = true;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		bool useDistanceField = false;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float distanceFieldCellSize = 20.0f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		int distanceFieldMaxResolution = 64;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		int distanceFieldCellsPerTick = 4096;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		bool useLod = true;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		TArray<FRopeLodLevel> lodLevels;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options", meta = (ClampMin = "0", ClampMax = "0.5"))
+		float lodHysteresis = 0.1f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float lodOffscreenDelay = 1.0f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float lodBlendTime = 0.5f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		bool allowSleep = true;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float sleepDisplacement = 0.1f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float sleepResidual = 1.0f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float sleepDelay = 0.5f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float sleepWakeDistance = 2.0f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float sleepGeometryCheckInterval = 0.25f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options", meta = (ClampMin = "0", ClampMax = "1"))
+		float pullStiffness = 0.2f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float maxPullForce = 200000.0f;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		bool keepSplineUpdated = false;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		bool useTubeMesh = true;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options", meta = (ClampMin = "3"))
+		int tubeSides = 8;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float tubeRadius = 3.0f;
+	UPROPERTY(VisibleAnywhere, Category = "Grapple Options")
+		TArray<URopePoint*> ropePoints;
+	UPROPERTY(VisibleAnywhere, Category = "Grapple Options")
+		USplineComponent* splineComponent;
+	UPROPERTY(VisibleAnywhere, Category = "Grapple Options")
+		TArray<USplineMeshComponent*> ropeMeshes;
+	UPROPERTY(VisibleAnywhere, Category = "Grapple Options")
+		UProceduralMeshComponent* tubeMesh;
+	UPROPERTY(VisibleInstanceOnly, Transient, Category = "Grapple Stats")
+		int iterationsUsed;
+	UPROPERTY(VisibleInstanceOnly, Transient, Category = "Grapple Stats")
+		float finalResidual;
+	UPROPERTY(VisibleInstanceOnly, Transient, Category = "Grapple Stats")
+		int pointsTraced;
+	UPROPERTY(VisibleInstanceOnly, Transient, Category = "Grapple Stats")
+		int currentLod;
+	UPROPERTY(VisibleInstanceOnly, Transient, Category = "Grapple Stats")
+		bool sleeping;
+
+	FRopeSimulation simulation;
+	FRopePhaseTimings phaseTimings;
+	bool recordPhaseTimings = false;
+	FRopeTickInput tickInput;
+	FRopeTickOutput tickOutput;
+	TSharedPtr<FRopeRecording> recording;
+	TArray<FTraceHandle> pendingProjectionTraces;
+	TArray<FBox> nearbyGeometryBounds;
+	TArray<FBox> nearbyMovableBounds;
+	FRopeDistanceField distanceField;
+	TArray<FRopeCorner> cornerCache;
+	TArray<FRopeWrap> wraps;
+	TArray<FVector> linePoints;
+	TArray<FVector> tubeVertices;
+	TArray<FVector> tubeNormals;
+	TArray<FVector2D> tubeUVs;
+	TArray<FProcMeshTangent> tubeTangents;
+	TArray<int32> tubeTriangles;
+	int tubeRingCount = 0;
+	int tubeSidesBuilt = 0;
+	int lodTubeSides = 0;
+	float lodSpacing = 0.0f;
+	float lodIterationScale = 1.0f;
+	float offscreenTime = 0.0f;
+	float stillTime = 0.0f;
+	float sleepGeometryCheckTime = 0.0f;
+	TArray<FBox> sleepGeometryBounds;
+	TArray<FBox> wakeGeometryBounds;
+	class URopePoolSubsystem* pool;
+	class URopeWorldSubsystem* ropeWorld;
+	AActor* anchorObject;
+	class UGrappleGun* grappleSource;
+	FVector anchorNormal;
+
+	float correctionTraceLength = 100.0f;
+	float majorityInfluence = 0.75f;
+	float outlierMultiplier = 10.0f;
+	int cornerBisectionSteps = 6;
+	float cornerSearchDistance = 400.0f;
+	float cornerSearchTolerance = 2.0f;
+	float cornerCacheNormalTolerance = 0.98f;
+
+	float ropeTempLength;
+	float timeAccumulator = 0.0f;
+	bool projectedWithDistanceField = false;
+
+	bool anchorIsMovable;
+	UPrimitiveComponent* anchorBody;
+	FVector anchorLocalOffset;
+
+	UStaticMesh* mesh;
+	class UMaterialInterface* defaultMaterial;
+};
@@ -0,0 +1,417 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RopeBenchmarkCommandlet.h"
+#include "Rope.h"
+#include "RopePoint.h"
+#include "RopeSimulation.h"
+#include "GrappleGun.h"
+#include "RopePoolSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRopeBenchmark, Log, All);
+
+//the staircase used by the corner-heavy scenario, both as analytic geometry and as spawned cubes
+static const float stairDepth = 40.0f;
+static const float stairHeight = 30.0f;
+static const int stairCount = 8;
+
+//the edge length of the physics cube the drag scenario pulls along its floor
+static const float dragCubeSize = 50.0f;
+
+//one rope stepped by solver mode, with the surface it can rest on
+struct FSolverRope
+{
+	FRopeSimulation simulation;
+	FVector held;
+	bool stairs = false;
+	bool floor = false;
+	float floorHeight = 0.0f;
+};
+
+static float GetStairHeight(float x)
+{
+	return -stairHeight * FMath::Clamp(FMath::FloorToFloat(x / stairDepth), 0.0f, (float)stairCount);
+}
+
+static void InitializeSolverRope(FSolverRope& solverRope, const FVector& held, const FVector& anchor, bool anchored)
+{
+	const URopePoint* pointDefaults = GetDefault<URopePoint>();
+	solverRope.simulation.pointRadius = pointDefaults->radius;
+	solverRope.simulation.gravitationalAcceleration = FVector3f(pointDefaults->gravitationalAcceleration);
+	solverRope.simulation.Initialize(held, anchor, 50.0f, pointDefaults->mass, anchored);
+	solverRope.held = held;
+}
+
+static void ProjectSolverRope(FSolverRope& solverRope)
+{
+	//stands in for ProjectPoints: anything under the surface is lifted onto it and loses its vertical velocity
+	if (!solverRope.stairs && !solverRope.floor) return;
+	FRopeSimulation& simulation = solverRope.simulation;
+	for (int i = 1; i < simulation.Num(); ++i) {
+		FVector position = simulation.GetPosition(i);
+		float surface = ((solverRope.stairs) ? GetStairHeight(position.X) : solverRope.floorHeight) + simulation.pointRadius;
+		if (position.Z >= surface) continue;
+
+		position.Z = surface;
+		simulation.SetPosition(i, position);
+		FVector previousPosition = simulation.GetPreviousPosition(i);
+		simulation.SetPreviousPosition(i, FVector(previousPosition.X, previousPosition.Y, surface));
+	}
+}
+
+static void StepSolverRopes(TArray<FSolverRope>& ropes, float stepTime, uint64& integrateCycles, uint64& constrainCycles, uint64& projectCycles)
+{
+	//the same iteration budget and tolerance a default ARope solves with at full detail
+	const ARope* ropeDefaults = GetDefault<ARope>();
+	const int minIterations = FMath::Max(3, ropeDefaults->GetMinConstraintIterations());
+	const int maxIterations = FMath::Max(minIterations, ropeDefaults->GetMaxConstraintIterations());
+	const float tolerance = ropeDefaults->GetErrorAcceptance();
+
+	//several ropes are stepped phase by phase across workers, the way the rope world subsystem runs them
+	auto ForEachRope = [&ropes](TFunctionRef<void(FSolverRope&)> body) {
+		if (ropes.Num() == 1) body(ropes[0]);
+		else ParallelFor(ropes.Num(), [&ropes, &body](int i) { body(ropes[i]); }, EParallelForFlags::Unbalanced);
+	};
+
+	//split a third before projection and two thirds after, as ARope::Simulate does
+	uint64 start = FPlatformTime::Cycles64();
+	ForEachRope([stepTime](FSolverRope& solverRope) { solverRope.simulation.Integrate(stepTime); solverRope.simulation.SetPosition(0, solverRope.held); });
+	uint64 integrated = FPlatformTime::Cycles64();
+	ForEachRope([=](FSolverRope& solverRope) { solverRope.simulation.SolveConstraints(minIterations / 3, maxIterations / 3, tolerance, solverRope.held); });
+	uint64 firstSolve = FPlatformTime::Cycles64();
+	ForEachRope([](FSolverRope& solverRope) { ProjectSolverRope(solverRope); });
+	uint64 projected = FPlatformTime::Cycles64();
+	ForEachRope([=](FSolverRope& solverRope) { solverRope.simulation.SolveConstraints(2 * minIterations / 3, 2 * maxIterations / 3, tolerance, solverRope.held); });
+	uint64 end = FPlatformTime::Cycles64();
+
+	integrateCycles += integrated - start;
+	constrainCycles += (firstSolve - integrated) + (end - projected);
+	projectCycles += projected - firstSolve;
+}
+
+static double CyclesToNsPerTick(uint64 cycles, int ticks)
+{
+	return cycles * FPlatformTime::GetSecondsPerCycle64() * 1e9 / FMath::Max(1, ticks);
+}
+
+URopeBenchmarkCommandlet::URopeBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 URopeBenchmarkCommandlet::Main(const FString& Params)
+{
+	FString mode = TEXT("all");
+	FString mapName = TEXT("/Game/Maps/City");
+	FString outputPath = FPaths::ProjectSavedDir() / TEXT("RopeBenchmark.json");
+	FParse::Value(*Params, TEXT("mode="), mode);
+	FParse::Value(*Params, TEXT("map="), mapName);
+	FParse::Value(*Params, TEXT("output="), outputPath);
+	FParse::Value(*Params, TEXT("ticks="), ticks);
+	FParse::Value(*Params, TEXT("ropes="), concurrentRopes);
+	allowSleep = FParse::Param(*Params, TEXT("allowsleep"));
+	ticks = FMath::Max(1, ticks);
+	concurrentRopes = FMath::Max(1, concurrentRopes);
+
+	results.Reset();
+	bool succeeded = true;
+	if (mode == TEXT("solver") || mode == TEXT("all")) RunSolverScenarios();
+	if (mode == TEXT("map") || mode == TEXT("all")) succeeded = RunMapScenarios(mapName);
+
+	TSharedRef<FJsonObject> report = MakeShared<FJsonObject>();
+	report->SetNumberField(TEXT("ticks"), ticks);
+	report->SetNumberField(TEXT("stepTime"), stepTime);
+	report->SetArrayField(TEXT("results"), results);
+
+	FString json;
+	TSharedRef<TJsonWriter<>> writer = TJsonWriterFactory<>::Create(&json);
+	FJsonSerializer::Serialize(report, writer);
+	if (!FFileHelper::SaveStringToFile(json, *outputPath)) {
+		UE_LOG(LogRopeBenchmark, Error, TEXT("Could not write %s"), *outputPath);
+		return 1;
+	}
+
+	UE_LOG(LogRopeBenchmark, Display, TEXT("Wrote %d results to %s"), results.Num(), *outputPath);
+	return (succeeded) ? 0 : 1;
+}
+
+void URopeBenchmarkCommandlet::RunSolverScenarios()
+{
+	const FVector anchor = FVector::ZeroVector;
+	const FString scenarios[] = { TEXT("hang"), TEXT("swing"), TEXT("stairs"), TEXT("reel"), TEXT("drag"), TEXT("concurrent") };
+
+	for (const FString& scenario : scenarios) {
+		TArray<FSolverRope> ropes;
+		ropes.SetNum((scenario == TEXT("concurrent")) ? concurrentRopes : 1);
+		for (int i = 0; i < ropes.Num(); ++i) {
+			FVector offset(0, i * 300.0f, 0);
+			if (scenario == TEXT("stairs")) {
+				InitializeSolverRope(ropes[i], FVector(stairCount * stairDepth + 300, 0, -stairCount * stairHeight + 100), FVector(10, 0, 5), true);
+				ropes[i].stairs = true;
+			}
+			else if (scenario == TEXT("drag")) {
+				//the pulled object is an unpinned anchor dragged along the floor it rests on
+				InitializeSolverRope(ropes[i], FVector(-800, 0, 0), anchor, false);
+				ropes[i].floor = true;
+				ropes[i].floorHeight = -ropes[i].simulation.pointRadius;
+			}
+			else InitializeSolverRope(ropes[i], anchor + offset + FVector(600, 0, -800), anchor + offset, true);
+		}
+
+		uint64 integrateCycles = 0, constrainCycles = 0, projectCycles = 0;
+		for (int tick = 0; tick < warmupTicks + ticks; ++tick) {
+			if (tick == warmupTicks) integrateCycles = constrainCycles = projectCycles = 0;
+
+			float time = tick * stepTime;
+			if (scenario == TEXT("swing")) ropes[0].held = anchor + 1000.0f * FVector(FMath::Sin(0.8f * FMath::Sin(PI * time)), 0, -FMath::Cos(0.8f * FMath::Sin(PI * time)));
+			else if (scenario == TEXT("drag")) ropes[0].held = FVector(-800 - 200.0f * time, 0, 0);
+			else if (scenario == TEXT("reel")) {
+				bool removedPoint;
+				if ((tick / 60) % 2 == 0) ropes[0].simulation.Extend(5.0f);
+				else ropes[0].simulation.Shorten(5.0f, removedPoint);
+			}
+			StepSolverRopes(ropes, stepTime, integrateCycles, constrainCycles, projectCycles);
+		}
+
+		int points = 0;
+		for (const FSolverRope& solverRope : ropes) {
+			points += solverRope.simulation.Num();
+		}
+		//corners, render prep and restraint don't exist without a world, so solver results don't report them
+		TArray<FBenchmarkPhase> phases = { { TEXT("integrateNsPerTick"), CyclesToNsPerTick(integrateCycles, ticks) }, { TEXT("constrainNsPerTick"), CyclesToNsPerTick(constrainCycles, ticks) } };
+		if (ropes[0].stairs || ropes[0].floor) phases.Add({ TEXT("projectNsPerTick"), CyclesToNsPerTick(projectCycles, ticks) });
+		AddResult(TEXT("solver"), scenario, ropes.Num(), points, phases);
+	}
+}
+
+bool URopeBenchmarkCommandlet::RunMapScenarios(const FString& mapName)
+{
+	UWorld* world = LoadMapWorld(mapName);
+	if (!world) {
+		UE_LOG(LogRopeBenchmark, Error, TEXT("Could not load map %s"), *mapName);
+		return false;
+	}
+
+	//scenarios are built well above the map so its own geometry only matters where a scenario asks for it
+	const FString scenarios[] = { TEXT("hang"), TEXT("swing"), TEXT("stairs"), TEXT("reel"), TEXT("drag"), TEXT("concurrent") };
+	for (const FString& scenario : scenarios) {
+		TArray<FMapRope> mapRopes;
+		TArray<AActor*> geometry;
+		const FVector anchor = mapOrigin;
+
+		if (scenario == TEXT("stairs")) {
+			SpawnStairs(world, anchor, geometry);
+			mapRopes.Add(SpawnMapRope(world, anchor + FVector(stairCount * stairDepth + 300, 0, -stairCount * stairHeight + 100), anchor + FVector(10, 0, 5), false));
+		}
+		else if (scenario == TEXT("drag")) {
+			//the pulled object is a physics cube resting on a floor, so the rope has a real body to drag
+			SpawnFloor(world, anchor - FVector(0, 0, dragCubeSize / 2), geometry);
+			mapRopes.Add(SpawnMapRope(world, anchor + FVector(-800, 0, 0), anchor, true));
+		}
+		else {
+			int count = (scenario == TEXT("concurrent")) ? concurrentRopes : 1;
+			for (int i = 0; i < count; ++i) {
+				FVector offset(0, i * 300.0f, 0);
+				mapRopes.Add(SpawnMapRope(world, anchor + offset + FVector(600, 0, -800), anchor + offset, false));
+			}
+		}
+
+		for (int tick = 0; tick < warmupTicks + ticks; ++tick) {
+			if (tick == warmupTicks) {
+				for (const FMapRope& mapRope : mapRopes) {
+					if (mapRope.rope) mapRope.rope->SetRecordPhaseTimings(true);
+				}
+			}
+
+			float time = tick * stepTime;
+			FMapRope& first = mapRopes[0];
+			if (first.rope && first.gun) {
+				if (scenario == TEXT("swing")) first.gun->SetWorldLocation(anchor + 1000.0f * FVector(FMath::Sin(0.8f * FMath::Sin(PI * time)), 0, -FMath::Cos(0.8f * FMath::Sin(PI * time))));
+				else if (scenario == TEXT("drag")) first.gun->SetWorldLocation(anchor + FVector(-800 - 200.0f * time, 0, 0));
+				else if (scenario == TEXT("reel")) {
+					if ((tick / 60) % 2 == 0) first.rope->Extend(5.0f);
+					else first.rope->Shorten(5.0f);
+				}
+			}
+			world->Tick(LEVELTICK_All, stepTime);
+		}
+
+		//projection time includes the corners found during it, so corners are taken back out
+		FRopePhaseTimings total;
+		int points = 0;
+		for (const FMapRope& mapRope : mapRopes) {
+			if (!mapRope.rope) continue;
+			const FRopePhaseTimings& timings = mapRope.rope->GetPhaseTimings();
+			total.integrate += timings.integrate;
+			total.constrain += timings.constrain;
+			total.project += timings.project - timings.corner;
+			total.corner += timings.corner;
+			total.renderPrep += timings.renderPrep;
+			total.restrain += timings.restrain;
+			points += mapRope.rope->GetPointCount();
+		}
+		TArray<FBenchmarkPhase> phases = {
+			{ TEXT("integrateNsPerTick"), CyclesToNsPerTick(total.integrate, ticks) },
+			{ TEXT("constrainNsPerTick"), CyclesToNsPerTick(total.constrain, ticks) },
+			{ TEXT("projectNsPerTick"), CyclesToNsPerTick(total.project, ticks) },
+			{ TEXT("cornerNsPerTick"), CyclesToNsPerTick(total.corner, ticks) },
+			{ TEXT("renderPrepNsPerTick"), CyclesToNsPerTick(total.renderPrep, ticks) }
+		};
+		if (scenario == TEXT("drag")) phases.Add({ TEXT("restrainNsPerTick"), CyclesToNsPerTick(total.restrain, ticks) });
+		AddResult(TEXT("map"), scenario, mapRopes.Num(), points, phases);
+
+		for (const FMapRope& mapRope : mapRopes) {
+			ReleaseMapRope(world, mapRope);
+		}
+		for (AActor* actor : geometry) {
+			actor->Destroy();
+		}
+	}
+
+	DestroyMapWorld(world);
+	return true;
+}
+
+UWorld* URopeBenchmarkCommandlet::LoadMapWorld(const FString& mapName)
+{
+	UPackage* package = LoadPackage(nullptr, *mapName, LOAD_None);
+	UWorld* world = (package) ? UWorld::FindWorldInPackage(package) : nullptr;
+	if (!world) return nullptr;
+
+	//brought up as a game world so the rope subsystems and their tick functions start exactly as they do in play
+	world->WorldType = EWorldType::Game;
+	world->AddToRoot();
+	FWorldContext& worldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	worldContext.SetCurrentWorld(world);
+	if (!world->bIsWorldInitialized) world->InitWorld(UWorld::InitializationValues().AllowAudioPlayback(false).RequiresHitProxies(false).CreatePhysicsScene(true).ShouldSimulatePhysics(true));
+	world->UpdateWorldComponents(true, false);
+
+	FURL url;
+	world->SetGameMode(url);
+	world->InitializeActorsForPlay(url);
+	world->BeginPlay();
+	return world;
+}
+
+void URopeBenchmarkCommandlet::DestroyMapWorld(UWorld* world)
+{
+	GEngine->DestroyWorldContext(world);
+	world->DestroyWorld(false);
+	world->RemoveFromRoot();
+}
+
+URopeBenchmarkCommandlet::FMapRope URopeBenchmarkCommandlet::SpawnMapRope(UWorld* world, const FVector& heldLocation, const FVector& anchorLocation, bool anchorCanMove)
+{
+	//the gun has no owning player, so it simply holds the rope wherever the scenario puts it
+	FMapRope mapRope;
+	mapRope.holder = world->SpawnActor<AActor>();
+	mapRope.gun = NewObject<UGrappleGun>(mapRope.holder);
+	mapRope.holder->SetRootComponent(mapRope.gun);
+	mapRope.gun->RegisterComponent();
+	mapRope.gun->SetWorldLocation(heldLocation);
+
+	//a movable anchor is a physics cube, which is what the rope pulls on; a fixed one only needs a location
+	mapRope.anchor = world->SpawnActor<AActor>();
+	UStaticMesh* cube = (anchorCanMove) ? LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube")) : nullptr;
+	UStaticMeshComponent* anchorBody = (cube) ? NewObject<UStaticMeshComponent>(mapRope.anchor) : nullptr;
+	USceneComponent* anchorRoot = (anchorBody) ? anchorBody : NewObject<USceneComponent>(mapRope.anchor);
+	mapRope.anchor->SetRootComponent(anchorRoot);
+	if (anchorBody) {
+		anchorBody->SetMobility(EComponentMobility::Movable);
+		anchorBody->SetStaticMesh(cube);
+		anchorBody->SetWorldScale3D(FVector(dragCubeSize / 100.0f));
+	}
+	anchorRoot->RegisterComponent();
+	mapRope.anchor->SetActorLocation(anchorLocation);
+	if (anchorBody) anchorBody->SetSimulatePhysics(true);
+
+	URopePoolSubsystem* pool = world->GetSubsystem<URopePoolSubsystem>();
+	mapRope.rope = (pool) ? pool->AcquireRope() : world->SpawnActor<ARope>();
+	if (!mapRope.rope) return mapRope;
+
+	mapRope.rope->SetObjectLocks(mapRope.anchor, mapRope.gun, anchorCanMove);
+	mapRope.rope->SetAllowSleep(allowSleep);
+	mapRope.rope->GeneratePoints(mapRope.gun->GetRopeOrigin(), anchorLocation);
+	return mapRope;
+}
+
+void URopeBenchmarkCommandlet::SpawnStairs(UWorld* world, const FVector& top, TArray<AActor*>& outActors)
+{
+	UStaticMesh* cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!cube) return;
+
+	//one box per step down to a shared base, then a long landing at the bottom; the cube mesh is 100 units across
+	float bottom = -stairCount * stairHeight - 100.0f;
+	for (int i = 0; i <= stairCount; ++i) {
+		float depth = (i == stairCount) ? 600.0f : stairDepth;
+		float stepTop = -i * stairHeight;
+		FVector centre = top + FVector(i * stairDepth + depth / 2, 0, (stepTop + bottom) / 2);
+
+		AStaticMeshActor* step = world->SpawnActor<AStaticMeshActor>(centre, FRotator::ZeroRotator);
+		if (!step) continue;
+		step->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+		step->GetStaticMeshComponent()->SetStaticMesh(cube);
+		step->SetActorScale3D(FVector(depth, 400.0f, stepTop - bottom) / 100.0f);
+		outActors.Add(step);
+	}
+}
+
+void URopeBenchmarkCommandlet::SpawnFloor(UWorld* world, const FVector& top, TArray<AActor*>& outActors)
+{
+	UStaticMesh* cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!cube) return;
+
+	//long enough that the dragged cube stays on it for the whole run
+	const FVector size(4000.0f, 400.0f, 100.0f);
+	AStaticMeshActor* floor = world->SpawnActor<AStaticMeshActor>(top + FVector(-size.X / 2 + 200.0f, 0, -size.Z / 2), FRotator::ZeroRotator);
+	if (!floor) return;
+	floor->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+	floor->GetStaticMeshComponent()->SetStaticMesh(cube);
+	floor->SetActorScale3D(size / 100.0f);
+	outActors.Add(floor);
+}
+
+void URopeBenchmarkCommandlet::ReleaseMapRope(UWorld* world, const FMapRope& mapRope)
+{
+	URopePoolSubsystem* pool = world->GetSubsystem<URopePoolSubsystem>();
+	if (mapRope.rope) {
+		mapRope.rope->SetRecordPhaseTimings(false);
+		if (pool) pool->ReleaseRope(mapRope.rope);
+		else mapRope.rope->Destroy();
+	}
+	if (mapRope.holder) mapRope.holder->Destroy();
+	if (mapRope.anchor) mapRope.anchor->Destroy();
+}
+
+void URopeBenchmarkCommandlet::AddResult(const FString& mode, const FString& scenario, int ropes, int points, TArrayView<const FBenchmarkPhase> phases)
+{
+	//only the phases a mode measured are written, so a missing key means not measured rather than free
+	TSharedRef<FJsonObject> result = MakeShared<FJsonObject>();
+	result->SetStringField(TEXT("mode"), mode);
+	result->SetStringField(TEXT("scenario"), scenario);
+	result->SetNumberField(TEXT("ropes"), ropes);
+	result->SetNumberField(TEXT("points"), points);
+
+	double totalNs = 0.0;
+	for (const FBenchmarkPhase& phase : phases) {
+		result->SetNumberField(phase.name, phase.nsPerTick);
+		totalNs += phase.nsPerTick;
+	}
+	result->SetNumberField(TEXT("totalNsPerTick"), totalNs);
+
+	UE_LOG(LogRopeBenchmark, Display, TEXT("%s %s: %d ropes, %d points, %.0f ns/tick"), *mode, *scenario, ropes, points, totalNs);
+	results.Add(MakeShared<FJsonValueObject>(result));
+}
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Dom/JsonObject.h"
+#include "RopeBenchmarkCommandlet.generated.h"
+
+class ARope;
+class UGrappleGun;
+
+/**
+ * Times the rope against canned scenarios and writes the per-phase cost as JSON, so regressions show
+ * up without playing the level. Solver mode steps FRopeSimulation on its own with analytic geometry;
+ * map mode loads a map, spawns real ropes above it and lets the world tick them.
+ *
+ *   UnrealEditor-Cmd RopeGrapple.uproject -run=RopeBenchmark -mode=solver|map|all [-map=/Game/Maps/City]
+ *       [-ticks=600] [-ropes=32] [-output=Saved/RopeBenchmark.json] [-allowsleep] -unattended -nullrhi
+ */
+UCLASS()
+class ROPEGRAPPLE_API URopeBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	URopeBenchmarkCommandlet();
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+	//a benchmarked rope in map mode and the actors holding each end of it
+	struct FMapRope
+	{
+		ARope* rope = nullptr;
+		AActor* holder = nullptr;
+		UGrappleGun* gun = nullptr;
+		AActor* anchor = nullptr;
+	};
+
+	//one measured phase of a result, keyed by its name in the JSON
+	struct FBenchmarkPhase
+	{
+		const TCHAR* name;
+		double nsPerTick;
+	};
+
+	void RunSolverScenarios();
+	bool RunMapScenarios(const FString& mapName);
+	UWorld* LoadMapWorld(const FString& mapName);
+	void DestroyMapWorld(UWorld* world);
+	FMapRope SpawnMapRope(UWorld* world, const FVector& heldLocation, const FVector& anchorLocation, bool anchorCanMove);
+	void SpawnStairs(UWorld* world, const FVector& top, TArray<AActor*>& outActors);
+	void SpawnFloor(UWorld* world, const FVector& top, TArray<AActor*>& outActors);
+	void ReleaseMapRope(UWorld* world, const FMapRope& mapRope);
+	void AddResult(const FString& mode, const FString& scenario, int ropes, int points, TArrayView<const FBenchmarkPhase> phases);
+
+	TArray<TSharedPtr<FJsonValue>> results;
+	int ticks = 600;
+	int warmupTicks = 60;
+	int concurrentRopes = 32;
+	float stepTime = 1.0f / 60.0f;
+	bool allowSleep = false;
+	FVector mapOrigin = FVector(0, 0, 50000);
+};
@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RopeDistanceField.h"
+#include "Engine/World.h"
+#include "Components/PrimitiveComponent.h"
+#include "WorldCollision.h"
+
+FRopeDistanceField::~FRopeDistanceField()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(levelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(levelRemovedHandle);
+}
+
+void FRopeDistanceField::Reset()
+{
+	distances.Reset();
+	sources.Reset();
+	sourceBounds.Reset();
+	unsupportedBounds.Reset();
+	resolution = FIntVector::ZeroValue;
+	region = FBox(ForceInit);
+	buildCursor = 0;
+	levelsChanged = false;
+}
+
+void FRopeDistanceField::SetRegion(UWorld* world, const FBox& desiredRegion, float desiredCellSize, int maxResolution, const AActor* ignoredActor)
+{
+	Reset();
+	if (!world) return;
+	sourceWorld = world;
+
+	//streaming can add or remove static geometry anywhere, so any level change makes the whole field stale
+	if (!levelAddedHandle.IsValid()) {
+		levelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddRaw(this, &FRopeDistanceField::OnLevelsChanged);
+		levelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddRaw(this, &FRopeDistanceField::OnLevelsChanged);
+	}
+
+	//cells grow past the desired size rather than letting a long rope allocate an unbounded grid
+	FVector size = desiredRegion.GetSize();
+	cellSize = FMath::Max(desiredCellSize, size.GetMax() / FMath::Max(2, maxResolution - 1));
+	bandDistance = 3 * cellSize;
+	resolution = FIntVector(FMath::CeilToInt(size.X / cellSize) + 1, FMath::CeilToInt(size.Y / cellSize) + 1, FMath::CeilToInt(size.Z / cellSize) + 1);
+	region = FBox(desiredRegion.Min, desiredRegion.Min + FVector(resolution.X - 1, resolution.Y - 1, resolution.Z - 1) * cellSize);
+	distances.SetNumUninitialized(resolution.X * resolution.Y * resolution.Z);
+
+	//only static geometry is baked; anything that can move is left to the rope's regular sweeps
+	TArray<FOverlapResult> overlaps;
+	FCollisionQueryParams queryParams(SCENE_QUERY_STAT(RopeDistanceField), false, ignoredActor);
+	world->OverlapMultiByChannel(overlaps, region.GetCenter(), FQuat::Identity, ECC_Visibility, FCollisionShape::MakeBox(region.GetExtent()), queryParams);
+
+	for (const FOverlapResult& overlap : overlaps) {
+		UPrimitiveComponent* component = overlap.GetComponent();
+		if (!component || component->Mobility != EComponentMobility::Static || component->GetCollisionResponseToChannel(ECC_Visibility) != ECR_Block) continue;
+		if (sources.Contains(component)) continue;
+
+		//distance queries are only answered by simple collision, so anything that can't answer is swept like moving geometry
+		FBox bounds = component->Bounds.GetBox();
+		FVector closestPoint;
+		if (component->GetDistanceToCollision(bounds.Max + FVector(bandDistance), closestPoint) < 0.0f) {
+			unsupportedBounds.Add(bounds);
+			continue;
+		}
+
+		sources.Add(component);
+		sourceBounds.Add(bounds.ExpandBy(bandDistance));
+	}
+}
+
+bool FRopeDistanceField::Build(int cellBudget)
+{
+	if (distances.Num() == 0) return false;
+
+	int lastCell = FMath::Min(buildCursor + cellBudget, distances.Num());
+	for (; buildCursor < lastCell; ++buildCursor) {
+		int x = buildCursor % resolution.X;
+		int y = (buildCursor / resolution.X) % resolution.Y;
+		int z = buildCursor / (resolution.X * resolution.Y);
+		distances[buildCursor] = ComputeDistance(region.Min + FVector(x, y, z) * cellSize);
+	}
+	return IsReady();
+}
+
+float FRopeDistanceField::ComputeDistance(const FVector& position) const
+{
+	//cells outside every source's band never need an exact distance
+	float distance = bandDistance;
+	for (int i = 0; i < sources.Num(); ++i) {
+		if (!sourceBounds[i].IsInsideOrOn(position)) continue;
+
+		UPrimitiveComponent* source = sources[i].Get();
+		FVector closestPoint;
+		float sourceDistance = (source) ? source->GetDistanceToCollision(position, closestPoint) : -1.0f;
+		if (sourceDistance >= 0.0f) distance = FMath::Min(distance, sourceDistance);
+	}
+	return distance;
+}
+
+bool FRopeDistanceField::IsStale() const
+{
+	if (levelsChanged) return true;
+	for (const TWeakObjectPtr<UPrimitiveComponent>& source : sources) {
+		if (!source.IsValid() || !source->IsRegistered()) return true;
+	}
+	return false;
+}
+
+bool FRopeDistanceField::IsNearUnsupportedGeometry(const FBox& bounds) const
+{
+	for (const FBox& unsupported : unsupportedBounds) {
+		if (unsupported.Intersect(bounds)) return true;
+	}
+	return false;
+}
+
+bool FRopeDistanceField::Sample(const FVector& position, float& outDistance, FVector& outGradient) const
+{
+	if (!IsReady()) return false;
+
+	FVector local = (position - region.Min) / cellSize;
+	int x = FMath::FloorToInt(local.X);
+	int y = FMath::FloorToInt(local.Y);
+	int z = FMath::FloorToInt(local.Z);
+	if (x < 0 || y < 0 || z < 0 || x >= resolution.X - 1 || y >= resolution.Y - 1 || z >= resolution.Z - 1) return false;
+
+	float fx = local.X - x;
+	float fy = local.Y - y;
+	float fz = local.Z - z;
+	auto At = [this](int cx, int cy, int cz) { return distances[cx + resolution.X * (cy + resolution.Y * cz)]; };
+	float c000 = At(x, y, z), c100 = At(x + 1, y, z), c010 = At(x, y + 1, z), c110 = At(x + 1, y + 1, z);
+	float c001 = At(x, y, z + 1), c101 = At(x + 1, y, z + 1), c011 = At(x, y + 1, z + 1), c111 = At(x + 1, y + 1, z + 1);
+
+	float c0 = FMath::Lerp(FMath::Lerp(c000, c100, fx), FMath::Lerp(c010, c110, fx), fy);
+	float c1 = FMath::Lerp(FMath::Lerp(c001, c101, fx), FMath::Lerp(c011, c111, fx), fy);
+	outDistance = FMath::Lerp(c0, c1, fz);
+
+	//analytic gradient of the trilinear blend, so the normal is continuous inside a cell
+	outGradient.X = FMath::Lerp(FMath::Lerp(c100 - c000, c110 - c010, fy), FMath::Lerp(c101 - c001, c111 - c011, fy), fz);
+	outGradient.Y = FMath::Lerp(FMath::Lerp(c010 - c000, c110 - c100, fx), FMath::Lerp(c011 - c001, c111 - c101, fx), fz);
+	outGradient.Z = c1 - c0;
+	outGradient /= cellSize;
+	return true;
+}
+
+void FRopeDistanceField::OnLevelsChanged(ULevel* level, UWorld* world)
+{
+	if (world == sourceWorld.Get()) levelsChanged = true;
+}
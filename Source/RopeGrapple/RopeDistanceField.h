@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+class ULevel;
+class UPrimitiveComponent;
+
+/**
+ * Cached distance-to-static-geometry grid over a box region, so rope points can find their contact
+ * with the world from a trilinear lookup instead of a scene query. Distances come from the static
+ * primitives' own collision and are unsigned (zero on and inside geometry) and truncated to a narrow
+ * band around surfaces, which is all point projection needs. The grid is filled over several ticks
+ * and goes stale when one of its source primitives goes away or a level is streamed in or out.
+ */
+class ROPEGRAPPLE_API FRopeDistanceField
+{
+public:
+	FRopeDistanceField() = default;
+	~FRopeDistanceField();
+	FRopeDistanceField(const FRopeDistanceField&) = delete;
+	FRopeDistanceField& operator=(const FRopeDistanceField&) = delete;
+
+	void SetRegion(UWorld* world, const FBox& desiredRegion, float desiredCellSize, int maxResolution, const AActor* ignoredActor);
+	bool Build(int cellBudget);
+	void Invalidate() { levelsChanged = true; };
+	void Reset();
+
+	bool HasRegion() const { return distances.Num() > 0; };
+	bool IsReady() const { return distances.Num() > 0 && buildCursor >= distances.Num(); };
+	bool IsStale() const;
+	bool Covers(const FBox& bounds) const { return distances.Num() > 0 && region.IsInsideOrOn(bounds.Min) && region.IsInsideOrOn(bounds.Max); };
+	bool IsNearUnsupportedGeometry(const FBox& bounds) const;
+	bool Sample(const FVector& position, float& outDistance, FVector& outGradient) const;
+	float GetCellSize() const { return cellSize; };
+
+protected:
+	float ComputeDistance(const FVector& position) const;
+	void OnLevelsChanged(ULevel* level, UWorld* world);
+
+	TArray<float> distances;
+	FIntVector resolution = FIntVector::ZeroValue;
+	FBox region = FBox(ForceInit);
+	float cellSize = 0.0f;
+	float bandDistance = 0.0f;
+	int buildCursor = 0;
+
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> sources;
+	TArray<FBox> sourceBounds;
+	TArray<FBox> unsupportedBounds;
+	TWeakObjectPtr<UWorld> sourceWorld;
+	bool levelsChanged = false;
+
+	FDelegateHandle levelAddedHandle;
+	FDelegateHandle levelRemovedHandle;
+};
@@ -1,7 +1,16 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-#include "RopeGrapple.h"
-#include "Modules/ModuleManager.h"
-
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, RopeGrapple, "RopeGrapple" );
- 
\ No newline at end of file
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RopeGrapple.h"
+#include "RopeStats.h"
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, RopeGrapple, "RopeGrapple" );
+
+DEFINE_STAT(STAT_RopeTraces);
+DEFINE_STAT(STAT_RopeSegments);
+DEFINE_STAT(STAT_RopeIterations);
+DEFINE_STAT(STAT_RopeObjectsCreated);
+DEFINE_STAT(STAT_RopeObjectsDestroyed);
+DEFINE_STAT(STAT_RopeSnapshotBytes);
+
+CSV_DEFINE_CATEGORY_MODULE(ROPEGRAPPLE_API, Rope, true);
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RopeGrappleMovementComponent.h"
+#include "RopeStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Swing Movement"), STAT_RopeSwingMovement, STATGROUP_Rope);
+
+void URopeGrappleMovementComponent::StartRopeSwing()
+{
+	SetMovementMode(MOVE_Custom, (uint8)ERopeCustomMovementMode::RopeSwing);
+}
+
+bool URopeGrappleMovementComponent::IsRopeSwinging() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == (uint8)ERopeCustomMovementMode::RopeSwing;
+}
+
+void URopeGrappleMovementComponent::SetRopeConstraint(const FVector& pivot, float length, const FVector& originOffset)
+{
+	//the constraint is on the gun's muzzle, which sits originOffset away from the character's location
+	hasRopeConstraint = true;
+	ropePivot = pivot;
+	ropeLength = length;
+	ropeOriginOffset = originOffset;
+}
+
+float URopeGrappleMovementComponent::GetMaxSpeed() const
+{
+	return (IsRopeSwinging()) ? maxSwingSpeed : Super::GetMaxSpeed();
+}
+
+void URopeGrappleMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
+{
+	if (CustomMovementMode == (uint8)ERopeCustomMovementMode::RopeSwing) PhysRopeSwing(deltaTime, Iterations);
+	else Super::PhysCustom(deltaTime, Iterations);
+}
+
+void URopeGrappleMovementComponent::PhysRopeSwing(float deltaTime, int32 Iterations)
+{
+	if (deltaTime < MIN_TICK_TIME) return;
+	SCOPE_ROPE_CYCLE_COUNTER(SwingMovement);
+
+	//swing input only pushes sideways; gravity does the rest
+	FVector input = FVector(Acceleration.X, Acceleration.Y, 0.0f) / FMath::Max(GetMaxAcceleration(), KINDA_SMALL_NUMBER);
+	Velocity += (FVector(0.0f, 0.0f, GetGravityZ()) + input * swingAcceleration) * deltaTime;
+	Velocity = Velocity.GetClampedToMaxSize(maxSwingSpeed);
+
+	//the rope only pulls: a muzzle that would end up past the rope's free length is brought back onto the sphere around the pivot
+	FVector oldLocation = UpdatedComponent->GetComponentLocation();
+	FVector delta = Velocity * deltaTime;
+	if (hasRopeConstraint) {
+		FVector muzzle = oldLocation + ropeOriginOffset + delta;
+		FVector fromPivot = muzzle - ropePivot;
+		if (fromPivot.SizeSquared() > ropeLength * ropeLength) delta += ropePivot + fromPivot.GetSafeNormal() * ropeLength - muzzle;
+	}
+
+	//one sweep, then one slide along whatever it hit; a floor ends the swing the way landing ends a fall
+	FHitResult hit(1.0f);
+	SafeMoveUpdatedComponent(delta, UpdatedComponent->GetComponentQuat(), true, hit);
+	INC_ROPE_COUNTER(Traces, 1);
+	if (hit.IsValidBlockingHit()) {
+		if (IsValidLandingSpot(UpdatedComponent->GetComponentLocation(), hit)) {
+			ProcessLanded(hit, deltaTime * (1.0f - hit.Time), Iterations);
+			return;
+		}
+		HandleImpact(hit, deltaTime, delta);
+		SlideAlongSurface(delta, 1.0f - hit.Time, hit.Normal, hit, true);
+		INC_ROPE_COUNTER(Traces, 1);
+	}
+
+	//velocity is what the move achieved, so the rope's pull and anything in the way both take their share
+	if (!bJustTeleported) Velocity = (UpdatedComponent->GetComponentLocation() - oldLocation) / deltaTime;
+}
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "RopeGrappleMovementComponent.generated.h"
+
+UENUM(BlueprintType)
+enum class ERopeCustomMovementMode : uint8
+{
+	RopeSwing = 0,
+};
+
+/**
+ * Character movement with a rope swing mode. While swinging the character falls and takes swing input like any
+ * other move, and is then held on the sphere the rope allows around its pivot (the anchor, or the wrap nearest
+ * the player). The move is one sweep plus one slide along whatever blocks it, so collision, network smoothing
+ * and client prediction work the same as in the built in movement modes.
+ */
+UCLASS()
+class ROPEGRAPPLE_API URopeGrappleMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	void StartRopeSwing();
+	bool IsRopeSwinging() const;
+	//set from the local rope each frame rather than saved with the move, so every machine constrains to its own rope
+	void SetRopeConstraint(const FVector& pivot, float length, const FVector& originOffset);
+	void ClearRopeConstraint() { hasRopeConstraint = false; };
+	virtual float GetMaxSpeed() const override;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		float swingAcceleration = 2700.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grapple Options")
+		float maxSwingSpeed = 4000.0f;
+
+protected:
+	virtual void PhysCustom(float deltaTime, int32 Iterations) override;
+	void PhysRopeSwing(float deltaTime, int32 Iterations);
+
+	bool hasRopeConstraint = false;
+	FVector ropePivot = FVector::ZeroVector;
+	float ropeLength = 0.0f;
+	FVector ropeOriginOffset = FVector::ZeroVector;
+};
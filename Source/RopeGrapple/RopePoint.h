@@ -1,38 +1,40 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Components/ActorComponent.h"
-#include "RopePoint.generated.h"
-
-
-UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
-class ROPEGRAPPLE_API URopePoint : public UActorComponent
-{
-	GENERATED_BODY()
-
-public:	
-	URopePoint();
-	void UpdatePoint(float deltaTime);
-	void ApplyForce(FVector force, float deltaTime);
-
-	UPROPERTY(EditAnywhere, Category = "Grapple Options")
-		float mass = 100.0;
-	UPROPERTY(EditAnywhere, Category = "Grapple Options")
-		float radius = 5.0;
-	UPROPERTY(EditAnywhere, Category = "Grapple Options")
-		bool isAnchor = false;
-	UPROPERTY(EditAnywhere, Category = "Grapple Options")
-		FVector gravitationalAcceleration = FVector(0, 0, -10000.0f);
-	UPROPERTY(EditAnywhere, Category = "Grapple Options")
-		FVector position;
-	UPROPERTY(EditAnywhere, Category = "Grapple Options")
-		FVector previousPosition;
-
-	int collisionsResolved = 0;
-	bool cornerFlag = false;
-
-protected:	
-	FVector velocity;
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "RopeSimulation.h"
+#include "RopePoint.generated.h"
+
+/**
+ * Thin view over a single point of an FRopeSimulation. The point's state lives in the simulation's
+ * arrays; the properties here are only the defaults the owning rope seeds the simulation with.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class ROPEGRAPPLE_API URopePoint : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:	
+	URopePoint();
+	void Bind(FRopeSimulation* simulation_, int index_) { simulation = simulation_; index = index_; };
+
+	FVector GetPosition() const { return simulation->GetPosition(index); };
+	void SetPosition(const FVector& position) { simulation->SetPosition(index, position); };
+	FVector GetPreviousPosition() const { return simulation->GetPreviousPosition(index); };
+	bool IsAnchor() const { return simulation->HasFlag(index, ERopePointFlags::Anchor); };
+	bool IsWrapped() const { return simulation->HasFlag(index, ERopePointFlags::Wrapped); };
+	int GetIndex() const { return index; };
+
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float mass = 100.0;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		float radius = 5.0;
+	UPROPERTY(EditAnywhere, Category = "Grapple Options")
+		FVector gravitationalAcceleration = FVector(0, 0, -10000.0f);
+
+protected:	
+	FRopeSimulation* simulation = nullptr;
+	int index = INDEX_NONE;
+};
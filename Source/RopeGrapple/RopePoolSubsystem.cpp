@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RopePoolSubsystem.h"
+#include "Rope.h"
+
+void URopePoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	//spawn the ropes up front and let the first one build the shared points and meshes
+	TArray<ARope*> prewarmed;
+	for (int i = 0; i < prewarmedRopes; ++i) {
+		prewarmed.Add(AcquireRope());
+	}
+	if (prewarmed.Num() > 0 && prewarmed[0]) prewarmed[0]->Prewarm(prewarmedSegments);
+
+	for (ARope* rope : prewarmed) {
+		ReleaseRope(rope);
+	}
+}
+
+ARope* URopePoolSubsystem::AcquireRope()
+{
+	ARope* rope = PopValid(freeRopes);
+	if (!rope) rope = GetWorld()->SpawnActor<ARope>();
+	if (!rope) return nullptr;
+
+	rope->SetPool(this);
+	return rope;
+}
+
+void URopePoolSubsystem::ReleaseRope(ARope* rope)
+{
+	if (!IsValid(rope)) return;
+
+	//pooled ropes stay visible; the meshes they hand back are hidden individually and move to whichever rope takes them next
+	rope->ReturnToPool(this);
+	freeRopes.AddUnique(rope);
+}
+
+URopePoint* URopePoolSubsystem::AcquireRopePoint()
+{
+	return PopValid(freeRopePoints);
+}
+
+void URopePoolSubsystem::ReleaseRopePoint(URopePoint* ropePoint)
+{
+	if (IsValid(ropePoint)) freeRopePoints.Add(ropePoint);
+}
+
+USplineMeshComponent* URopePoolSubsystem::AcquireSplineMesh()
+{
+	USplineMeshComponent* splineMesh = PopValid(freeSplineMeshes);
+	if (splineMesh) splineMesh->SetVisibility(true);
+	return splineMesh;
+}
+
+void URopePoolSubsystem::ReleaseSplineMesh(USplineMeshComponent* splineMesh)
+{
+	if (!IsValid(splineMesh)) return;
+
+	splineMesh->SetVisibility(false);
+	freeSplineMeshes.Add(splineMesh);
+}
+
+template<typename T>
+T* URopePoolSubsystem::PopValid(TArray<T*>& freeList)
+{
+	//entries can be invalidated underneath us if their outer was torn down (e.g. level streaming)
+	while (freeList.Num() > 0) {
+		T* pooled = freeList.Pop(false);
+		if (IsValid(pooled)) return pooled;
+	}
+	return nullptr;
+}
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "RopePoolSubsystem.generated.h"
+
+class ARope;
+class URopePoint;
+class USplineMeshComponent;
+
+/**
+ * Per-world free lists for ropes and the objects they are built from. Ropes, rope point views and
+ * spline meshes are handed back here instead of being destroyed, so reeling and repeated
+ * fire/release cycles stop allocating UObjects once the pool is warm.
+ */
+UCLASS(config = Game)
+class ROPEGRAPPLE_API URopePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override { return WorldType == EWorldType::Game || WorldType == EWorldType::PIE; };
+
+	ARope* AcquireRope();
+	void ReleaseRope(ARope* rope);
+
+	URopePoint* AcquireRopePoint();
+	void ReleaseRopePoint(URopePoint* ropePoint);
+	USplineMeshComponent* AcquireSplineMesh();
+	void ReleaseSplineMesh(USplineMeshComponent* splineMesh);
+
+	int GetFreeRopeCount() const { return freeRopes.Num(); };
+	int GetFreeRopePointCount() const { return freeRopePoints.Num(); };
+	int GetFreeSplineMeshCount() const { return freeSplineMeshes.Num(); };
+
+protected:
+	template<typename T> T* PopValid(TArray<T*>& freeList);
+
+	UPROPERTY(config)
+		int prewarmedRopes = 1;
+	UPROPERTY(config)
+		int prewarmedSegments = 48;
+
+	UPROPERTY()
+		TArray<ARope*> freeRopes;
+	UPROPERTY()
+		TArray<URopePoint*> freeRopePoints;
+	UPROPERTY()
+		TArray<USplineMeshComponent*> freeSplineMeshes;
+};
@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RopeReplay.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+static const uint32 recordingMagic = 0x52504c59;
+static const uint32 trajectoryMagic = 0x5254524a;
+static const int32 replayVersion = 4;
+
+static FArchive& operator<<(FArchive& archive, FRopeWrap& wrap)
+{
+	return archive << wrap.index << wrap.location << wrap.edgeNormal;
+}
+
+static FArchive& operator<<(FArchive& archive, FRopeContact& contact)
+{
+	return archive << contact.index << contact.impactPoint;
+}
+
+static FArchive& operator<<(FArchive& archive, FRopeTickInput& input)
+{
+	archive << input.substeps << input.stepTime << input.minIterations << input.maxIterations << input.projectPoints << input.heldPosition;
+	return archive << input.contacts << input.newWraps;
+}
+
+static FArchive& operator<<(FArchive& archive, FRopeReplayEvent& event)
+{
+	return archive << (uint8&)event.type << event.index << event.amount << event.location;
+}
+
+static FArchive& operator<<(FArchive& archive, FRopeReplayFrame& frame)
+{
+	archive << frame.deltaTime << frame.gunTransform << frame.anchorTransform << frame.input;
+	return archive << frame.events << frame.positions;
+}
+
+//both files are read back whole; a wrong magic or version leaves the archive in error rather than misreading the rest
+static bool SerializeHeader(FArchive& archive, uint32 magic)
+{
+	uint32 fileMagic = magic;
+	int32 version = replayVersion;
+	archive << fileMagic << version;
+	if (fileMagic != magic || version != replayVersion) archive.SetError();
+	return !archive.IsError();
+}
+
+static bool SaveArchive(const FString& path, TFunctionRef<void(FArchive&)> serialize)
+{
+	TArray<uint8> bytes;
+	FMemoryWriter writer(bytes);
+	serialize(writer);
+	return FFileHelper::SaveArrayToFile(bytes, *path);
+}
+
+static bool LoadArchive(const FString& path, TFunctionRef<void(FArchive&)> serialize)
+{
+	TArray<uint8> bytes;
+	if (!FFileHelper::LoadFileToArray(bytes, *path)) return false;
+	FMemoryReader reader(bytes);
+	serialize(reader);
+	return !reader.IsError();
+}
+
+bool FRopeRecording::SaveToFile(const FString& path)
+{
+	return SaveArchive(path, [this](FArchive& archive) { Serialize(archive); });
+}
+
+bool FRopeRecording::LoadFromFile(const FString& path)
+{
+	return LoadArchive(path, [this](FArchive& archive) { Serialize(archive); });
+}
+
+void FRopeRecording::Serialize(FArchive& archive)
+{
+	if (!SerializeHeader(archive, recordingMagic)) return;
+	initialState.Serialize(archive);
+	archive << initialWraps << errorAcceptance << frames;
+}
+
+bool FRopeTrajectory::SaveToFile(const FString& path)
+{
+	return SaveArchive(path, [this](FArchive& archive) { Serialize(archive); });
+}
+
+bool FRopeTrajectory::LoadFromFile(const FString& path)
+{
+	return LoadArchive(path, [this](FArchive& archive) { Serialize(archive); });
+}
+
+void FRopeTrajectory::Serialize(FArchive& archive)
+{
+	if (!SerializeHeader(archive, trajectoryMagic)) return;
+	archive << frames;
+}
+
+bool FRopeTrajectory::Compare(const FRopeTrajectory& trajectory, const FRopeTrajectory& golden, float tolerance, int& outFirstMismatch, float& outMaxError)
+{
+	//a tolerance of zero asks for the exact same bits, which also catches differences in how NaNs or signed zeros came out
+	outFirstMismatch = INDEX_NONE;
+	outMaxError = 0.0f;
+	int frameCount = FMath::Max(trajectory.frames.Num(), golden.frames.Num());
+	for (int f = 0; f < frameCount; ++f) {
+		bool matches = trajectory.frames.IsValidIndex(f) && golden.frames.IsValidIndex(f) && trajectory.frames[f].Num() == golden.frames[f].Num();
+		if (matches && tolerance <= 0.0f) matches = FMemory::Memcmp(trajectory.frames[f].GetData(), golden.frames[f].GetData(), trajectory.frames[f].Num() * sizeof(FVector3f)) == 0;
+		else if (matches) {
+			for (int i = 0; i < trajectory.frames[f].Num(); ++i) {
+				float error = FVector3f::Distance(trajectory.frames[f][i], golden.frames[f][i]);
+				outMaxError = FMath::Max(outMaxError, error);
+				matches &= error <= tolerance;
+			}
+		}
+
+		if (!matches && outFirstMismatch == INDEX_NONE) outFirstMismatch = f;
+	}
+	return outFirstMismatch == INDEX_NONE;
+}
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Rope.h"
+
+//a change the game thread made to a rope's simulation, or the simulate stage itself; replaying them in order reproduces the frame
+struct FRopeReplayEvent
+{
+	enum class EType : uint8
+	{
+		Extend,
+		Shorten,
+		Resample,
+		Simulate,
+		SetPosition,
+		ClearVelocities,
+	};
+
+	EType type = EType::Simulate;
+	int32 index = INDEX_NONE;
+	float amount = 0.0f;
+	FVector location = FVector::ZeroVector;
+};
+
+//one rope frame: what drove it, what the game thread did to the simulation, and where the points ended up
+struct FRopeReplayFrame
+{
+	float deltaTime = 0.0f;
+	FTransform gunTransform;
+	FTransform anchorTransform;
+	FRopeTickInput input;
+	TArray<FRopeReplayEvent> events;
+	TArray<FVector3f> positions;
+};
+
+/**
+ * Everything needed to step a rope offline exactly as it was stepped in game: the simulation and wraps as
+ * they were when recording started, followed by every frame's input and game-thread events. Scene queries
+ * aren't repeated on playback, their results are part of the recording, so no world is needed to play it.
+ */
+struct ROPEGRAPPLE_API FRopeRecording
+{
+	bool SaveToFile(const FString& path);
+	bool LoadFromFile(const FString& path);
+	void Serialize(FArchive& archive);
+
+	FRopeSimulation initialState;
+	TArray<FRopeWrap> initialWraps;
+	float errorAcceptance = 0.0f;
+	TArray<FRopeReplayFrame> frames;
+};
+
+//point positions at the end of every frame of a playback, compared against a golden run to validate solver changes
+struct ROPEGRAPPLE_API FRopeTrajectory
+{
+	bool SaveToFile(const FString& path);
+	bool LoadFromFile(const FString& path);
+	void Serialize(FArchive& archive);
+	static bool Compare(const FRopeTrajectory& trajectory, const FRopeTrajectory& golden, float tolerance, int& outFirstMismatch, float& outMaxError);
+
+	TArray<TArray<FVector3f>> frames;
+};
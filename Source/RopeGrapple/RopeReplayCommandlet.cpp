@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RopeReplayCommandlet.h"
+#include "Rope.h"
+#include "RopeReplay.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRopeReplay, Log, All);
+
+URopeReplayCommandlet::URopeReplayCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 URopeReplayCommandlet::Main(const FString& Params)
+{
+	FString replayPath;
+	FString goldenPath;
+	float tolerance = 0.0f;
+	int repeat = 1;
+	FParse::Value(*Params, TEXT("replay="), replayPath);
+	FParse::Value(*Params, TEXT("golden="), goldenPath);
+	FParse::Value(*Params, TEXT("tolerance="), tolerance);
+	FParse::Value(*Params, TEXT("repeat="), repeat);
+	FString outputPath = FPaths::ChangeExtension(replayPath, TEXT("ropetrajectory"));
+	FParse::Value(*Params, TEXT("output="), outputPath);
+
+	FRopeRecording recording;
+	if (replayPath.IsEmpty() || !recording.LoadFromFile(replayPath)) {
+		UE_LOG(LogRopeReplay, Error, TEXT("Could not load rope recording '%s'"), *replayPath);
+		return 1;
+	}
+
+	//the rope only needs its simulate stage here, so it is never spawned into a world
+	ARope* rope = NewObject<ARope>(GetTransientPackage());
+	FRopeTrajectory trajectory;
+	double startTime = FPlatformTime::Seconds();
+	for (int run = 0; run < FMath::Max(1, repeat); ++run) {
+		rope->BeginReplay(recording);
+		for (const FRopeReplayFrame& frame : recording.frames) {
+			rope->ReplayFrame(frame);
+			if (run > 0) continue;
+
+			const FRopeSimulation& simulation = rope->GetSimulation();
+			TArray<FVector3f>& positions = trajectory.frames.AddDefaulted_GetRef();
+			positions.SetNumUninitialized(simulation.Num());
+			for (int i = 0; i < simulation.Num(); ++i) {
+				positions[i] = FVector3f(simulation.GetPosition(i));
+			}
+		}
+	}
+	double elapsedMs = (FPlatformTime::Seconds() - startTime) * 1000.0;
+	UE_LOG(LogRopeReplay, Display, TEXT("Replayed %d frames %d times in %.2f ms (%.3f ms per frame)"), recording.frames.Num(), FMath::Max(1, repeat), elapsedMs,
+		elapsedMs / FMath::Max(1, recording.frames.Num() * FMath::Max(1, repeat)));
+
+	if (!trajectory.SaveToFile(outputPath)) {
+		UE_LOG(LogRopeReplay, Error, TEXT("Could not write %s"), *outputPath);
+		return 1;
+	}
+
+	FRopeTrajectory golden;
+	if (!goldenPath.IsEmpty()) {
+		if (!golden.LoadFromFile(goldenPath)) {
+			UE_LOG(LogRopeReplay, Error, TEXT("Could not load golden trajectory '%s'"), *goldenPath);
+			return 1;
+		}
+	}
+	else {
+		for (const FRopeReplayFrame& frame : recording.frames) {
+			golden.frames.Add(frame.positions);
+		}
+	}
+
+	int firstMismatch;
+	float maxError;
+	if (!FRopeTrajectory::Compare(trajectory, golden, tolerance, firstMismatch, maxError)) {
+		UE_LOG(LogRopeReplay, Error, TEXT("Trajectory diverges from %s at frame %d (largest error %f, tolerance %f)"),
+			(goldenPath.IsEmpty()) ? TEXT("the recording") : *goldenPath, firstMismatch, maxError, tolerance);
+		return 1;
+	}
+
+	UE_LOG(LogRopeReplay, Display, TEXT("Trajectory matches %s (largest error %f); written to %s"), (goldenPath.IsEmpty()) ? TEXT("the recording") : *goldenPath, maxError, *outputPath);
+	return 0;
+}
@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "RopeReplayCommandlet.generated.h"
+
+/**
+ * Plays a rope recording (made in game with rope.StartRecording / rope.StopRecording) back through the solver
+ * without a world, writes the trajectory it produced and checks it against a golden trajectory. Without
+ * -golden the recording's own in-game positions are the reference, which checks playback is faithful.
+ * A tolerance of zero requires a bit-for-bit match. -repeat steps the recording again for profiling.
+ *
+ *   UnrealEditor-Cmd RopeGrapple.uproject -run=RopeReplay -replay=Saved/RopeReplays/X.roperecording
+ *       [-output=Saved/RopeReplays/X.ropetrajectory] [-golden=Y.ropetrajectory] [-tolerance=0] [-repeat=1] -unattended -nullrhi
+ */
+UCLASS()
+class ROPEGRAPPLE_API URopeReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	URopeReplayCommandlet();
+	virtual int32 Main(const FString& Params) override;
+};
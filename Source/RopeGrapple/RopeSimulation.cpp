@@ -0,0 +1,500 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RopeSimulation.h"
+#include "Async/ParallelFor.h"
+
+static FORCEINLINE FVector3f ToVector3(const FVector4f& vector)
+{
+	return FVector3f(vector.X, vector.Y, vector.Z);
+}
+
+void FRopeSimulation::Initialize(const FVector& startLocation, const FVector& endLocation, float desiredDistanceBetweenPoints, float pointMass, bool anchored)
+{
+	Reset();
+	defaultInverseMass = (pointMass > 0) ? 1.0f / pointMass : 0.0f;
+
+	ropeLength = FVector::Dist(startLocation, endLocation);
+	int segments = FMath::Max(1, FMath::CeilToInt(ropeLength / desiredDistanceBetweenPoints));
+	realDistanceBetweenPoints = ropeLength / segments;
+	transitionaryInDistance = realDistanceBetweenPoints;
+	transitionaryOutDistance = 0.1f;
+
+	FVector3f location = FVector3f(startLocation);
+	FVector3f displacement = FVector3f(endLocation - startLocation).GetSafeNormal() * realDistanceBetweenPoints;
+
+	//there should be one more point than segments
+	for (int i = 0; i <= segments; ++i) {
+		AddPoint(FVector4f(location, 0.0f), defaultInverseMass);
+		location += displacement;
+	}
+
+	//add an artificial point at the same position as the anchor to be used as the point transitioning out (adding points).
+	//the anchor always lives in the last slot, so the duplicate is appended and the previous last slot becomes the out point
+	transitionaryOutIndex = segments;
+	AddPoint(positions[transitionaryOutIndex], defaultInverseMass);
+
+	//the point right before the transitioning out point will be used as the point transitioning in (removing points)
+	transitionaryInIndex = transitionaryOutIndex - 1;
+
+	if (anchored) {
+		SetFlag(GetAnchorIndex(), ERopePointFlags::Anchor);
+		inverseMasses[GetAnchorIndex()] = 0.0f;
+	}
+
+	ropeLength *= initialGiveMultiplier;
+}
+
+void FRopeSimulation::Reset()
+{
+	positions.Reset();
+	previousPositions.Reset();
+	stepStartPositions.Reset();
+	inverseMasses.Reset();
+	flags.Reset();
+	collisionsResolved.Reset();
+	transitionaryOutIndex = transitionaryInIndex = -1;
+	lastResidual = 0.0f;
+}
+
+void FRopeSimulation::Integrate(float deltaTime)
+{
+	//remember where this step started so rendering can interpolate between fixed steps
+	stepStartPositions = positions;
+
+	if (useSimdKernels) {
+		IntegrateSimd(deltaTime);
+		return;
+	}
+
+	//scalar reference path
+	for (int i = 0; i < positions.Num(); ++i) {
+		if (!HasFlag(i, ERopePointFlags::Anchor | ERopePointFlags::Wrapped)) IntegratePoint(i, gravitationalAcceleration, deltaTime);
+	}
+}
+
+void FRopeSimulation::IntegratePoint(int ind, const FVector3f& acceleration, float deltaTime)
+{
+	FVector3f position = ToVector3(positions[ind]);
+	FVector3f velocity = position - ToVector3(previousPositions[ind]);
+	if (collisionsResolved[ind] > 0 && velocity.SquaredLength() > maxCollisionVelocity * maxCollisionVelocity) {
+		velocity = velocity.GetSafeNormal() * maxCollisionVelocity;
+		--collisionsResolved[ind];
+	}
+	previousPositions[ind] = positions[ind];
+	positions[ind] = FVector4f(position + velocity + acceleration * (deltaTime * deltaTime), 0.0f);
+}
+
+void FRopeSimulation::IntegrateSimd(float deltaTime)
+{
+	//the padding lane is zero in positions, previous positions and gravity, so it stays zero through the whole step
+	const VectorRegister4Float gravityStep = VectorMultiply(MakeVectorRegisterFloat(gravitationalAcceleration.X, gravitationalAcceleration.Y, gravitationalAcceleration.Z, 0.0f), VectorSetFloat1(deltaTime * deltaTime));
+	const VectorRegister4Float maxVelocity = VectorSetFloat1(maxCollisionVelocity);
+	const float maxVelocitySquared = maxCollisionVelocity * maxCollisionVelocity;
+	float* position = &positions.GetData()->X;
+	float* previousPosition = &previousPositions.GetData()->X;
+
+	for (int i = 0; i < positions.Num(); ++i, position += 4, previousPosition += 4) {
+		if (HasFlag(i, ERopePointFlags::Anchor | ERopePointFlags::Wrapped)) continue;
+
+		const VectorRegister4Float current = VectorLoad(position);
+		VectorRegister4Float velocity = VectorSubtract(current, VectorLoad(previousPosition));
+
+		//the length is only needed while a point is still settling from a collision, which is rare
+		if (collisionsResolved[i] > 0) {
+			const VectorRegister4Float lengthSquared = VectorDot3(velocity, velocity);
+			if (VectorGetComponent(lengthSquared, 0) > maxVelocitySquared) {
+				velocity = VectorMultiply(velocity, VectorMultiply(maxVelocity, VectorReciprocalSqrt(lengthSquared)));
+				--collisionsResolved[i];
+			}
+		}
+
+		VectorStore(current, previousPosition);
+		VectorStore(VectorAdd(current, VectorAdd(velocity, gravityStep)), position);
+	}
+}
+
+void FRopeSimulation::SolveConstraints(int iterations, const FVector& heldPosition)
+{
+	RunIterations(iterations, FVector4f(FVector3f(heldPosition), 0.0f));
+}
+
+int FRopeSimulation::SolveConstraints(int minIterations, int maxIterations, float errorTolerance, const FVector& heldPosition)
+{
+	const FVector4f held = FVector4f(FVector3f(heldPosition), 0.0f);
+	int iterationsUsed = FMath::Clamp(minIterations, 0, maxIterations);
+	RunIterations(iterationsUsed, held);
+	lastResidual = ComputeResidual();
+
+	//measuring the residual costs about half an iteration, so it is only checked every few iterations
+	while (iterationsUsed < maxIterations && lastResidual > errorTolerance) {
+		int batch = FMath::Min(residualCheckInterval, maxIterations - iterationsUsed);
+		RunIterations(batch, held);
+		iterationsUsed += batch;
+		lastResidual = ComputeResidual();
+	}
+	return iterationsUsed;
+}
+
+void FRopeSimulation::RunIterations(int iterations, const FVector4f& held)
+{
+	if (iterations <= 0) return;
+	if (solverMode == ERopeSolverMode::RedBlack) {
+		if (useSimdKernels) SolveRedBlack<true>(iterations, held);
+		else SolveRedBlack<false>(iterations, held);
+	}
+	else {
+		if (useSimdKernels) SolveSequential<true>(iterations, held);
+		else SolveSequential<false>(iterations, held);
+	}
+}
+
+template<bool bSimd>
+void FRopeSimulation::SolveSequential(int iterations, const FVector4f& held)
+{
+	auto ConstrainEdge = [this](int indA, int indB, float constraintDist) {
+		if constexpr (bSimd) ConstrainSimd(indA, indB, constraintDist);
+		else Constrain(indA, indB, constraintDist);
+	};
+
+	for (int iteration = 0; iteration < iterations; ++iteration) {
+		//the point we're holding is always located at the tip of the grapple gun
+		positions[0] = held;
+
+		//all the "middle" points are held normally
+		for (int i = 1; i < transitionaryInIndex - 1; ++i) {
+			ConstrainEdge(i, i - 1, realDistanceBetweenPoints);
+			ConstrainEdge(i + 1, i, realDistanceBetweenPoints);
+		}
+
+		//distance between the two transitionary points is the transition IN dist, dist between out transition and anchor is transition OUT dist
+		if (transitionaryInIndex > 0) ConstrainEdge(transitionaryInIndex, transitionaryInIndex - 1, realDistanceBetweenPoints);
+		ConstrainEdge(transitionaryOutIndex, transitionaryInIndex, transitionaryInDistance);
+		if (transitionaryOutIndex < GetAnchorIndex()) ConstrainEdge(transitionaryOutIndex + 1, transitionaryOutIndex, transitionaryOutDistance);
+	}
+}
+
+template<bool bSimd>
+void FRopeSimulation::SolveRedBlack(int iterations, const FVector4f& held)
+{
+	//edge k joins point k to point k - 1, so edges of the same parity never share a point and can be solved in any order
+	const int edgeCount = positions.Num() - 1;
+	const int blockSize = FMath::Max(2, parallelEdgeThreshold / 2) & ~1;
+	const int blockCount = FMath::DivideAndRoundUp(edgeCount, blockSize);
+
+	for (int iteration = 0; iteration < iterations; ++iteration) {
+		positions[0] = held;
+
+		for (int parity = 1; parity >= 0; --parity) {
+			if (edgeCount < parallelEdgeThreshold) {
+				SolveEdgeRange<bSimd>(2 - parity, edgeCount);
+			}
+			else {
+				ParallelFor(blockCount, [this, parity, blockSize, edgeCount](int block) {
+					//blocks hold an even number of edges, so every block starts on the same colour
+					int blockStart = block * blockSize;
+					SolveEdgeRange<bSimd>(blockStart + 2 - parity, FMath::Min(blockStart + blockSize, edgeCount));
+				});
+			}
+		}
+	}
+}
+
+template<bool bSimd>
+void FRopeSimulation::SolveEdgeRange(int firstEdge, int lastEdge)
+{
+	for (int edge = firstEdge; edge <= lastEdge; edge += 2) {
+		if constexpr (bSimd) ConstrainSimd(edge, edge - 1, GetRestLength(edge));
+		else Constrain(edge, edge - 1, GetRestLength(edge));
+	}
+}
+
+void FRopeSimulation::Constrain(int indA, int indB, float constraintDist)
+{
+	float weightA, weightB;
+	if (!GetCorrectionWeights(indA, indB, weightA, weightB)) return;
+
+	FVector3f difference = ToVector3(positions[indA]) - ToVector3(positions[indB]);
+	float distance = difference.Length() - constraintDist * stiffness;
+	float percent = (constraintDist > 0) ? (distance / constraintDist) : 1;
+	difference *= FMath::Clamp(percent, 0.0f, 1.0f);
+
+	positions[indA] = FVector4f(ToVector3(positions[indA]) - difference * weightA, 0.0f);
+	positions[indB] = FVector4f(ToVector3(positions[indB]) + difference * weightB, 0.0f);
+}
+
+void FRopeSimulation::ConstrainSimd(int indA, int indB, float constraintDist)
+{
+	float weightA, weightB;
+	if (!GetCorrectionWeights(indA, indB, weightA, weightB)) return;
+
+	//a zero rest length always applies the full correction, which a huge inverse reproduces without a branch
+	const float inverseConstraintDist = (constraintDist > 0) ? 1.0f / constraintDist : 1e30f;
+	float* positionA = &positions[indA].X;
+	float* positionB = &positions[indB].X;
+
+	const VectorRegister4Float a = VectorLoad(positionA);
+	const VectorRegister4Float b = VectorLoad(positionB);
+	const VectorRegister4Float difference = VectorSubtract(a, b);
+	const VectorRegister4Float distance = VectorSubtract(VectorSqrt(VectorDot3(difference, difference)), VectorSetFloat1(constraintDist * stiffness));
+	const VectorRegister4Float percent = VectorMin(VectorMax(VectorMultiply(distance, VectorSetFloat1(inverseConstraintDist)), VectorZeroFloat()), VectorOneFloat());
+	const VectorRegister4Float correction = VectorMultiply(difference, percent);
+
+	VectorStore(VectorSubtract(a, VectorMultiply(correction, VectorSetFloat1(weightA))), positionA);
+	VectorStore(VectorAdd(b, VectorMultiply(correction, VectorSetFloat1(weightB))), positionB);
+}
+
+bool FRopeSimulation::GetCorrectionWeights(int indA, int indB, float& weightA, float& weightB) const
+{
+	const ERopePointFlags pinned = ERopePointFlags::Anchor | ERopePointFlags::Wrapped;
+	if (HasFlag(indB, pinned)) {
+		weightA = 1.0f;
+		weightB = 0.0f;
+		return true;
+	}
+	if (HasFlag(indA, pinned)) {
+		weightA = 0.0f;
+		weightB = 1.0f;
+		return true;
+	}
+
+	//split the correction by inverse mass, which is an even split for the uniform ropes we generate
+	float totalInverseMass = inverseMasses[indA] + inverseMasses[indB];
+	if (totalInverseMass <= 0) return false;
+	weightA = inverseMasses[indA] / totalInverseMass;
+	weightB = 1.0f - weightA;
+	return true;
+}
+
+float FRopeSimulation::ComputeResidual() const
+{
+	//largest amount any segment is stretched past its rest length; slack segments count as satisfied.
+	//the first segment is skipped since the held point is re-pinned every iteration and its stretch is the pull on the player
+	float residual = 0.0f;
+	for (int edge = 2; edge < positions.Num(); ++edge) {
+		float length = FVector3f::Dist(ToVector3(positions[edge]), ToVector3(positions[edge - 1]));
+		residual = FMath::Max(residual, length - GetRestLength(edge));
+	}
+	return residual;
+}
+
+float FRopeSimulation::ComputeMaxDisplacement() const
+{
+	//how far any point moved over the last step, which is its speed under Verlet
+	float maxDisplacementSquared = 0.0f;
+	for (int i = 0; i < positions.Num(); ++i) {
+		maxDisplacementSquared = FMath::Max(maxDisplacementSquared, FVector3f::DistSquared(ToVector3(positions[i]), ToVector3(previousPositions[i])));
+	}
+	return FMath::Sqrt(maxDisplacementSquared);
+}
+
+void FRopeSimulation::ClearVelocities()
+{
+	for (int i = 0; i < positions.Num(); ++i) {
+		previousPositions[i] = stepStartPositions[i] = positions[i];
+	}
+}
+
+float FRopeSimulation::GetRestLengthTo(int ind) const
+{
+	//rest length of the rope from the held point up to the given point
+	float length = FMath::Min(ind, transitionaryOutIndex - 1) * realDistanceBetweenPoints;
+	if (ind >= transitionaryOutIndex) length += transitionaryInDistance;
+	if (ind > transitionaryOutIndex) length += (ind - transitionaryOutIndex) * transitionaryOutDistance;
+	return length;
+}
+
+FBox FRopeSimulation::GetBounds() const
+{
+	FBox3f bounds(ForceInit);
+	for (const FVector4f& position : positions) {
+		bounds += ToVector3(position);
+	}
+	return FBox(bounds);
+}
+
+float FRopeSimulation::MeasureKernelDeviation(float deltaTime, int iterations, const FVector& heldPosition) const
+{
+	//step a scalar and a SIMD copy of the current state and report how far apart they end up
+	FRopeSimulation scalar = *this;
+	FRopeSimulation simd = *this;
+	scalar.useSimdKernels = false;
+	simd.useSimdKernels = true;
+
+	scalar.Integrate(deltaTime);
+	scalar.SolveConstraints(iterations, heldPosition);
+	simd.Integrate(deltaTime);
+	simd.SolveConstraints(iterations, heldPosition);
+
+	float maxDeviation = 0.0f;
+	for (int i = 0; i < positions.Num(); ++i) {
+		maxDeviation = FMath::Max(maxDeviation, FVector3f::Dist(ToVector3(scalar.positions[i]), ToVector3(simd.positions[i])));
+	}
+	return maxDeviation;
+}
+
+bool FRopeSimulation::Extend(float rateOfChange)
+{
+	if (transitionaryInDistance < realDistanceBetweenPoints) transitionaryInDistance += rateOfChange;
+	else transitionaryOutDistance += rateOfChange;
+
+	if (transitionaryOutDistance < realDistanceBetweenPoints) return false;
+
+	++transitionaryOutIndex;
+	++transitionaryInIndex;
+
+	//instead of inserting before the anchor, move the anchor one slot further out and reuse its old slot as the
+	//new transitionary out point, which starts on top of the anchor. this keeps reeling out O(1) regardless of length
+	const int anchorIndex = AddPoint(positions[transitionaryOutIndex], inverseMasses[transitionaryOutIndex]);
+	CopyPoint(transitionaryOutIndex, anchorIndex);
+	previousPositions[transitionaryOutIndex] = positions[transitionaryOutIndex];
+	inverseMasses[transitionaryOutIndex] = defaultInverseMass;
+	flags[transitionaryOutIndex] = ERopePointFlags::None;
+	collisionsResolved[transitionaryOutIndex] = 0;
+
+	transitionaryOutDistance = 0.0f;
+	ropeLength += realDistanceBetweenPoints;
+	return true;
+}
+
+bool FRopeSimulation::Shorten(float rateOfChange, bool& removedPoint)
+{
+	removedPoint = false;
+	if (positions.Num() <= 4) return false; //a rope is minimum 3 points - start, end, and the artificial transition out point.
+
+	if (transitionaryOutDistance > 0) transitionaryOutDistance -= rateOfChange;
+	else transitionaryInDistance -= rateOfChange;
+
+	if (transitionaryInDistance <= 0) {
+		//shift the out point and anchor down over the in point and drop the last slot, rather than removing mid-array
+		CopyPoint(transitionaryOutIndex, transitionaryInIndex);
+		CopyPoint(GetAnchorIndex(), transitionaryOutIndex);
+		RemoveLastPoint();
+		--transitionaryInIndex;
+		--transitionaryOutIndex;
+
+		transitionaryInDistance = realDistanceBetweenPoints;
+		ropeLength -= realDistanceBetweenPoints;
+		removedPoint = true;
+	}
+
+	return true;
+}
+
+void FRopeSimulation::Resample(float desiredDistanceBetweenPoints)
+{
+	const int anchorIndex = GetAnchorIndex();
+	if (anchorIndex < 3 || desiredDistanceBetweenPoints <= 0) return;
+
+	//the rest length is spread over the new segments, folding in any partly reeled transitionary length
+	const float length = GetLength();
+	const float restLength = GetRestLengthTo(anchorIndex);
+	const int segments = FMath::Max(2, FMath::RoundToInt((restLength - 0.1f) / desiredDistanceBetweenPoints));
+
+	TArray<float> arcLengths;
+	arcLengths.SetNumUninitialized(anchorIndex + 1);
+	arcLengths[0] = 0.0f;
+	for (int i = 1; i <= anchorIndex; ++i) {
+		arcLengths[i] = arcLengths[i - 1] + FVector3f::Distance(ToVector3(positions[i - 1]), ToVector3(positions[i]));
+	}
+
+	//new points are placed evenly along the current shape and take their velocity and render start position from the same spot
+	TArray<FVector4f> newPositions, newPreviousPositions, newStepStartPositions;
+	newPositions.Reserve(segments + 1);
+	newPreviousPositions.Reserve(segments + 1);
+	newStepStartPositions.Reserve(segments + 1);
+	int edge = 0;
+	for (int i = 0; i <= segments; ++i) {
+		float target = arcLengths[anchorIndex] * i / segments;
+		while (edge < anchorIndex - 1 && arcLengths[edge + 1] < target) ++edge;
+		float span = arcLengths[edge + 1] - arcLengths[edge];
+		float alpha = (span > KINDA_SMALL_NUMBER) ? FMath::Clamp((target - arcLengths[edge]) / span, 0.0f, 1.0f) : 0.0f;
+		newPositions.Add(FMath::Lerp(positions[edge], positions[edge + 1], alpha));
+		newPreviousPositions.Add(FMath::Lerp(previousPositions[edge], previousPositions[edge + 1], alpha));
+		newStepStartPositions.Add(FMath::Lerp(stepStartPositions[edge], stepStartPositions[edge + 1], alpha));
+	}
+
+	const FVector4f anchorPosition = positions[anchorIndex];
+	const FVector4f anchorPreviousPosition = previousPositions[anchorIndex];
+	const FVector4f anchorStepStartPosition = stepStartPositions[anchorIndex];
+	const float anchorInverseMass = inverseMasses[anchorIndex];
+	const ERopePointFlags anchorFlags = flags[anchorIndex];
+
+	positions.Reset();
+	previousPositions.Reset();
+	stepStartPositions.Reset();
+	inverseMasses.Reset();
+	flags.Reset();
+	collisionsResolved.Reset();
+	for (int i = 0; i <= segments; ++i) {
+		AddPoint(newPositions[i], defaultInverseMass);
+		previousPositions[i] = newPreviousPositions[i];
+		stepStartPositions[i] = newStepStartPositions[i];
+	}
+
+	//same layout as Initialize: the last sampled point is the out point, sitting on the anchor
+	const int newAnchorIndex = AddPoint(anchorPosition, anchorInverseMass);
+	previousPositions[newAnchorIndex] = anchorPreviousPosition;
+	stepStartPositions[newAnchorIndex] = anchorStepStartPosition;
+	flags[newAnchorIndex] = anchorFlags;
+
+	transitionaryOutIndex = segments;
+	transitionaryInIndex = segments - 1;
+	transitionaryOutDistance = 0.1f;
+	realDistanceBetweenPoints = (restLength - transitionaryOutDistance) / segments;
+	transitionaryInDistance = realDistanceBetweenPoints;
+	ropeLength = length - transitionaryOutDistance;
+}
+
+void FRopeSimulation::Serialize(FArchive& archive)
+{
+	//full precision, tunables included, so a loaded simulation steps exactly like the one that was saved
+	archive << positions << previousPositions << stepStartPositions << inverseMasses << collisionsResolved;
+	int32 pointCount = flags.Num();
+	archive << pointCount;
+	if (archive.IsLoading()) flags.SetNumUninitialized(pointCount);
+	for (ERopePointFlags& flag : flags) {
+		archive << (uint8&)flag;
+	}
+
+	archive << realDistanceBetweenPoints << ropeLength << transitionaryOutIndex << transitionaryInIndex << transitionaryOutDistance << transitionaryInDistance;
+	archive << maxCollisionVelocity << defaultInverseMass << lastResidual;
+	archive << gravitationalAcceleration << stiffness << pointRadius << initialGiveMultiplier << useSimdKernels;
+	archive << (uint8&)solverMode << parallelEdgeThreshold << residualCheckInterval;
+}
+
+void FRopeSimulation::SetFlag(int ind, ERopePointFlags flag, bool value)
+{
+	if (value) flags[ind] |= flag;
+	else flags[ind] &= ~flag;
+}
+
+int FRopeSimulation::AddPoint(FVector4f location, float inverseMass)
+{
+	positions.Add(location);
+	previousPositions.Add(location);
+	stepStartPositions.Add(location);
+	inverseMasses.Add(inverseMass);
+	flags.Add(ERopePointFlags::None);
+	return collisionsResolved.Add(0);
+}
+
+void FRopeSimulation::CopyPoint(int fromInd, int toInd)
+{
+	positions[toInd] = positions[fromInd];
+	previousPositions[toInd] = previousPositions[fromInd];
+	stepStartPositions[toInd] = stepStartPositions[fromInd];
+	inverseMasses[toInd] = inverseMasses[fromInd];
+	flags[toInd] = flags[fromInd];
+	collisionsResolved[toInd] = collisionsResolved[fromInd];
+}
+
+void FRopeSimulation::RemoveLastPoint()
+{
+	positions.Pop(false);
+	previousPositions.Pop(false);
+	stepStartPositions.Pop(false);
+	inverseMasses.Pop(false);
+	flags.Pop(false);
+	collisionsResolved.Pop(false);
+}
@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class ERopePointFlags : uint8
+{
+	None = 0,
+	Anchor = 1 << 0,
+	//pinned where the rope wraps over an edge; stays set until the owner releases the wrap
+	Wrapped = 1 << 1,
+};
+ENUM_CLASS_FLAGS(ERopePointFlags);
+
+enum class ERopeSolverMode : uint8
+{
+	//Gauss-Seidel sweep from the held point to the anchor; the reference mode
+	Sequential,
+	//even and odd chain constraints solved as two independent sets per iteration
+	RedBlack,
+};
+
+/**
+ * Engine-independent Verlet rope solver. Point state is kept in parallel contiguous arrays so the
+ * integrate and constraint loops never leave cache; ARope and URopePoint only hold views into it.
+ * Positions are padded to 16 bytes so each point is a single vector register in the SIMD kernels.
+ * Index 0 is the held point, the last index is the anchor, and the two points before the anchor
+ * are the transitionary in/out points used to reel the rope in and out smoothly. Reeling only
+ * ever pushes or pops the last slot, so the arrays never shift.
+ */
+class ROPEGRAPPLE_API FRopeSimulation
+{
+public:
+	void Initialize(const FVector& startLocation, const FVector& endLocation, float desiredDistanceBetweenPoints, float pointMass, bool anchored);
+	void Reset();
+
+	void Integrate(float deltaTime);
+	void IntegratePoint(int ind, const FVector3f& acceleration, float deltaTime);
+	void SolveConstraints(int iterations, const FVector& heldPosition);
+	int SolveConstraints(int minIterations, int maxIterations, float errorTolerance, const FVector& heldPosition);
+	void Constrain(int indA, int indB, float constraintDist);
+	void ConstrainSimd(int indA, int indB, float constraintDist);
+	float MeasureKernelDeviation(float deltaTime, int iterations, const FVector& heldPosition) const;
+	float ComputeResidual() const;
+	float ComputeMaxDisplacement() const;
+	void ClearVelocities();
+
+	bool Extend(float rateOfChange);
+	bool Shorten(float rateOfChange, bool& removedPoint);
+	void Resample(float desiredDistanceBetweenPoints);
+	void Serialize(FArchive& archive);
+
+	int Num() const { return positions.Num(); }
+	int GetAnchorIndex() const { return positions.Num() - 1; };
+	int GetTransitionaryInIndex() const { return transitionaryInIndex; };
+	int GetTransitionaryOutIndex() const { return transitionaryOutIndex; };
+	float GetLength() const { return ropeLength + transitionaryOutDistance - (realDistanceBetweenPoints - transitionaryInDistance); };
+	float GetDistanceBetweenPoints() const { return realDistanceBetweenPoints; };
+	float GetRestLengthTo(int ind) const;
+	float GetLastResidual() const { return lastResidual; };
+	FBox GetBounds() const;
+
+	FVector GetPosition(int ind) const { return FVector(positions[ind].X, positions[ind].Y, positions[ind].Z); };
+	void SetPosition(int ind, const FVector& position) { positions[ind] = FVector4f(FVector3f(position), 0.0f); };
+	FVector GetInterpolatedPosition(int ind, float alpha) const { const FVector4f position = FMath::Lerp(stepStartPositions[ind], positions[ind], alpha); return FVector(position.X, position.Y, position.Z); };
+	FVector GetPreviousPosition(int ind) const { return FVector(previousPositions[ind].X, previousPositions[ind].Y, previousPositions[ind].Z); };
+	void SetPreviousPosition(int ind, const FVector& position) { previousPositions[ind] = FVector4f(FVector3f(position), 0.0f); };
+	float GetInverseMass(int ind) const { return inverseMasses[ind]; };
+	bool HasFlag(int ind, ERopePointFlags flag) const { return EnumHasAnyFlags(flags[ind], flag); };
+	void SetFlag(int ind, ERopePointFlags flag, bool value = true);
+	void AddResolvedCollisions(int ind, int count) { collisionsResolved[ind] += count; };
+
+	FVector3f gravitationalAcceleration = FVector3f(0, 0, -10000.0f);
+	float stiffness = 0.93f;
+	float pointRadius = 5.0f;
+	float initialGiveMultiplier = 1.05f;
+	bool useSimdKernels = true;
+	ERopeSolverMode solverMode = ERopeSolverMode::Sequential;
+	int parallelEdgeThreshold = 1024;
+	int residualCheckInterval = 4;
+
+protected:
+	friend struct FRopeSnapshot;
+
+	void IntegrateSimd(float deltaTime);
+	void RunIterations(int iterations, const FVector4f& heldPosition);
+	template<bool bSimd> void SolveSequential(int iterations, const FVector4f& heldPosition);
+	template<bool bSimd> void SolveRedBlack(int iterations, const FVector4f& heldPosition);
+	template<bool bSimd> void SolveEdgeRange(int firstEdge, int lastEdge);
+	float GetRestLength(int edge) const { return (edge == transitionaryOutIndex) ? transitionaryInDistance : (edge > transitionaryOutIndex) ? transitionaryOutDistance : realDistanceBetweenPoints; };
+	bool GetCorrectionWeights(int indA, int indB, float& weightA, float& weightB) const;
+	int AddPoint(FVector4f location, float inverseMass);
+	void CopyPoint(int fromInd, int toInd);
+	void RemoveLastPoint();
+
+	TArray<FVector4f> positions;
+	TArray<FVector4f> previousPositions;
+	TArray<FVector4f> stepStartPositions;
+	TArray<float> inverseMasses;
+	TArray<ERopePointFlags> flags;
+	TArray<uint8> collisionsResolved;
+
+	float realDistanceBetweenPoints = 0.0f;
+	float ropeLength = 0.0f;
+	int transitionaryOutIndex = -1;
+	int transitionaryInIndex = -1;
+	float transitionaryOutDistance = 0.1f;
+	float transitionaryInDistance = 0.0f;
+	float maxCollisionVelocity = 3.0f;
+	float defaultInverseMass = 0.01f;
+	float lastResidual = 0.0f;
+};
@@ -0,0 +1,218 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RopeSimulation.h"
+#include "Rope.h"
+#include "RopePoint.h"
+#include "RopeSnapshot.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRopeSimdKernelTest, "RopeGrapple.Simulation.SimdKernelsMatchScalar", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRopeSimdKernelTest::RunTest(const FString& Parameters)
+{
+	const float stepTime = 1.0f / 60.0f;
+	const int iterations = 100;
+	const float tolerance = 0.05f;
+	const FVector anchor = FVector::ZeroVector;
+	const ERopeSolverMode solverModes[] = { ERopeSolverMode::Sequential, ERopeSolverMode::RedBlack };
+
+	for (ERopeSolverMode solverMode : solverModes) {
+		FRopeSimulation simulation;
+		simulation.solverMode = solverMode;
+		simulation.Initialize(FVector(600, 0, -800), anchor, 50.0f, 1.0f, true);
+
+		//swing the held end for a while first, so the kernels are compared on a rope that is moving and stretched
+		float maxDeviation = 0.0f;
+		for (int tick = 0; tick < 120; ++tick) {
+			float angle = 0.8f * FMath::Sin(PI * tick * stepTime);
+			FVector held = anchor + 1000.0f * FVector(FMath::Sin(angle), 0, -FMath::Cos(angle));
+			maxDeviation = FMath::Max(maxDeviation, simulation.MeasureKernelDeviation(stepTime, iterations, held));
+
+			simulation.Integrate(stepTime);
+			simulation.SetPosition(0, held);
+			simulation.SolveConstraints(iterations, held);
+		}
+
+		const TCHAR* modeName = (solverMode == ERopeSolverMode::Sequential) ? TEXT("Sequential") : TEXT("RedBlack");
+		TestTrue(FString::Printf(TEXT("%s SIMD kernels stay within %f of the scalar reference (deviated by %f)"), modeName, tolerance, maxDeviation), maxDeviation <= tolerance);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRopeSolverConvergenceTest, "RopeGrapple.Simulation.SolverModesConverge", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRopeSolverConvergenceTest::RunTest(const FString& Parameters)
+{
+	const float stepTime = 1.0f / 60.0f;
+	const float targetResidual = 0.1f;
+	const int maxIterations = 1000;
+
+	//a rope swung with some slack, then stepped once more so both modes start from the same unsolved frame
+	FRopeSimulation simulation;
+	simulation.Initialize(FVector(600, 0, -800), FVector::ZeroVector, 50.0f, 1.0f, true);
+	FVector held;
+	for (int tick = 0; tick <= 60; ++tick) {
+		float angle = 0.8f * FMath::Sin(PI * tick * stepTime);
+		held = 800.0f * FVector(FMath::Sin(angle), 0, -FMath::Cos(angle));
+		simulation.Integrate(stepTime);
+		simulation.SetPosition(0, held);
+		if (tick < 60) simulation.SolveConstraints(100, held);
+	}
+
+	//one iteration at a time, so the counts aren't rounded up to the residual check interval
+	auto IterationsToTarget = [&simulation, &held, targetResidual, maxIterations](ERopeSolverMode solverMode) {
+		FRopeSimulation solved = simulation;
+		solved.solverMode = solverMode;
+		int iterations = 0;
+		while (solved.ComputeResidual() > targetResidual && iterations < maxIterations) {
+			solved.SolveConstraints(1, held);
+			++iterations;
+		}
+		return (solved.ComputeResidual() <= targetResidual) ? iterations : INDEX_NONE;
+	};
+	int sequentialIterations = IterationsToTarget(ERopeSolverMode::Sequential);
+	int redBlackIterations = IterationsToTarget(ERopeSolverMode::RedBlack);
+
+	AddInfo(FString::Printf(TEXT("%d points from a residual of %f down to %f: Sequential %d iterations, RedBlack %d iterations"), simulation.Num(), simulation.ComputeResidual(), targetResidual, sequentialIterations, redBlackIterations));
+	TestTrue(TEXT("Sequential reaches the target residual"), sequentialIterations != INDEX_NONE);
+	TestTrue(TEXT("RedBlack reaches the target residual"), redBlackIterations != INDEX_NONE);
+	TestTrue(TEXT("Sequential needs no more iterations than RedBlack on a rope this short"), sequentialIterations <= redBlackIterations);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRopeAdjacentCornerWrapTest, "RopeGrapple.Rope.AdjacentCornersWrapOnce", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRopeAdjacentCornerWrapTest::RunTest(const FString& Parameters)
+{
+	UWorld* world = UWorld::CreateWorld(EWorldType::Game, false);
+	ARope* rope = world->SpawnActor<ARope>();
+	if (!TestNotNull(TEXT("Rope spawned"), rope)) {
+		world->DestroyWorld(false);
+		return false;
+	}
+
+	//a rope draped over a ridge at point 3, which both the pair before it and the pair after it find a corner at
+	rope->simulation.Initialize(FVector::ZeroVector, FVector(500, 0, 0), 50.0f, 1.0f, true);
+	const int ridge = 3;
+	const FVector ridgeLocation(150, 0, 100);
+	rope->WrapPoint({ ridge, ridgeLocation, FVector::UpVector });
+	rope->WrapPoint({ ridge, ridgeLocation, FVector::DownVector });
+	TestEqual(TEXT("The second corner doesn't add a wrap"), rope->wraps.Num(), 1);
+
+	//the rope still presses into the ridge from above, so the wrap holds and stays the pivot
+	rope->ReleaseUnwrappedPoints();
+	TestEqual(TEXT("The wrap is kept while the rope presses on its edge"), rope->wraps.Num(), 1);
+	TestTrue(TEXT("The wrapped point stays flagged"), rope->simulation.HasFlag(ridge, ERopePointFlags::Wrapped));
+	TestEqual(TEXT("The wrapped point is the pivot"), rope->GetPivotIndex(), ridge);
+
+	//once both neighbours are lifted above the ridge the rope pulls off its edge, and nothing is left pinned
+	rope->simulation.SetPosition(ridge - 1, FVector(100, 0, 200));
+	rope->simulation.SetPosition(ridge + 1, FVector(200, 0, 200));
+	rope->ReleaseUnwrappedPoints();
+	TestEqual(TEXT("The wrap is released"), rope->wraps.Num(), 0);
+	TestFalse(TEXT("The released point is unflagged"), rope->simulation.HasFlag(ridge, ERopePointFlags::Wrapped));
+	TestEqual(TEXT("The anchor is the pivot again"), rope->GetPivotIndex(), rope->simulation.GetAnchorIndex());
+
+	world->DestroyWorld(false);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRopeSnapshotTest, "RopeGrapple.Snapshot.RoundTripAndSize", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRopeSnapshotTest::RunTest(const FString& Parameters)
+{
+	const float stepTime = 1.0f / 60.0f;
+	const float precision = 0.1f;
+	const FVector anchor = FVector::ZeroVector;
+
+	//a swinging rope, so the snapshot carries real velocities and the delta has points that moved
+	FRopeSimulation simulation;
+	simulation.Initialize(FVector(600, 0, -800), anchor, 50.0f, 1.0f, true);
+	auto Step = [&simulation, stepTime](int tick) {
+		float angle = 0.8f * FMath::Sin(PI * tick * stepTime);
+		FVector held = 1000.0f * FVector(FMath::Sin(angle), 0, -FMath::Cos(angle));
+		simulation.Integrate(stepTime);
+		simulation.SetPosition(0, held);
+		simulation.SolveConstraints(100, held);
+	};
+	for (int tick = 0; tick < 60; ++tick) {
+		Step(tick);
+	}
+
+	//a restored point may be up to half a step off on each axis
+	const float tolerance = precision * 0.5f * FMath::Sqrt(3.0f) + KINDA_SMALL_NUMBER;
+	auto TestRestored = [this, tolerance](const TCHAR* what, const FRopeSnapshot& snapshot, const FRopeSimulation& expected) {
+		FRopeSimulation restored;
+		TArray<FRopeWrap> wraps;
+		snapshot.Apply(restored, wraps);
+		if (!TestEqual(FString::Printf(TEXT("%s restores every point"), what), restored.Num(), expected.Num())) return;
+		float maxError = 0.0f;
+		for (int i = 0; i < expected.Num(); ++i) {
+			maxError = FMath::Max(maxError, FVector::Dist(restored.GetPosition(i), expected.GetPosition(i)));
+		}
+		TestTrue(FString::Printf(TEXT("%s restores positions to within the quantization step (off by %f)"), what, maxError), maxError <= tolerance);
+		TestEqual(FString::Printf(TEXT("%s restores the transitionary out index"), what), restored.GetTransitionaryOutIndex(), expected.GetTransitionaryOutIndex());
+		TestEqual(FString::Printf(TEXT("%s restores the transitionary in index"), what), restored.GetTransitionaryInIndex(), expected.GetTransitionaryInIndex());
+	};
+
+	FRopeSnapshot keyframe;
+	keyframe.Capture(simulation, TArray<FRopeWrap>(), precision);
+	FBitWriter keyframeWriter(0, true);
+	keyframe.Serialize(keyframeWriter);
+	FBitReader keyframeReader(keyframeWriter.GetData(), keyframeWriter.GetNumBits());
+	FRopeSnapshot readKeyframe;
+	readKeyframe.Serialize(keyframeReader);
+	TestFalse(TEXT("The keyframe reads back"), keyframeReader.IsError());
+	TestRestored(TEXT("The keyframe"), readKeyframe, simulation);
+
+	Step(60);
+	FRopeSnapshot next;
+	next.Capture(simulation, TArray<FRopeWrap>(), precision);
+	FBitWriter deltaWriter(0, true);
+	next.SerializeDelta(deltaWriter, keyframe);
+	FBitReader deltaReader(deltaWriter.GetData(), deltaWriter.GetNumBits());
+	FRopeSnapshot readDelta;
+	readDelta.SerializeDelta(deltaReader, readKeyframe);
+	TestFalse(TEXT("The delta reads back"), deltaReader.IsError());
+	TestRestored(TEXT("The delta"), readDelta, simulation);
+
+	//the naive form is each point saved as the URopePoint component the rope used to keep: every tagged property, plus its position
+	//and previous position, which are only counted as raw vectors here even though they were tagged properties too
+	TArray<uint8> naiveBytes;
+	FMemoryWriter naiveWriter(naiveBytes);
+	URopePoint* point = NewObject<URopePoint>();
+	for (int i = 0; i < simulation.Num(); ++i) {
+		URopePoint::StaticClass()->SerializeTaggedProperties(naiveWriter, (uint8*)point, URopePoint::StaticClass(), nullptr);
+		FVector position = simulation.GetPosition(i);
+		FVector previousPosition = simulation.GetPreviousPosition(i);
+		naiveWriter << position << previousPosition;
+	}
+
+	int64 keyframeBytes = keyframeWriter.GetNumBytes();
+	int64 deltaBytes = deltaWriter.GetNumBytes();
+	AddInfo(FString::Printf(TEXT("%d points: naive %d bytes, keyframe %lld bytes, delta %lld bytes"), simulation.Num(), naiveBytes.Num(), keyframeBytes, deltaBytes));
+	TestTrue(TEXT("A keyframe is at least an order of magnitude smaller than the naive form"), keyframeBytes * 10 <= naiveBytes.Num());
+	TestTrue(TEXT("A delta is smaller than a keyframe"), deltaBytes < keyframeBytes);
+
+	//values a hostile packet could carry are refused rather than dequantized into NaNs
+	FRopeSnapshot corrupt = keyframe;
+	corrupt.quantizationStep = NAN;
+	FBitWriter corruptWriter(0, true);
+	corrupt.Serialize(corruptWriter);
+	TestTrue(TEXT("A snapshot with a non-finite step is rejected"), corruptWriter.IsError());
+	corrupt = keyframe;
+	corrupt.realDistanceBetweenPoints = -1.0f;
+	FBitWriter negativeWriter(0, true);
+	corrupt.Serialize(negativeWriter);
+	TestTrue(TEXT("A snapshot with a negative segment length is rejected"), negativeWriter.IsError());
+	return true;
+}
+
+#endif
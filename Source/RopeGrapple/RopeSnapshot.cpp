@@ -0,0 +1,240 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RopeSnapshot.h"
+#include "Rope.h"
+
+//snapshots can arrive from the network, so a corrupt count fails the archive instead of allocating whatever it says
+static const int32 maxSnapshotPoints = 4096;
+
+//small magnitudes of either sign pack into a single byte
+static void SerializeZigZag(FArchive& archive, int32& value)
+{
+	uint32 packed = ((uint32)value << 1) ^ (uint32)(value >> 31);
+	archive.SerializeIntPacked(packed);
+	if (archive.IsLoading()) value = (int32)(packed >> 1) ^ -(int32)(packed & 1);
+}
+
+static void SerializeZigZag(FArchive& archive, FIntVector& value)
+{
+	SerializeZigZag(archive, value.X);
+	SerializeZigZag(archive, value.Y);
+	SerializeZigZag(archive, value.Z);
+}
+
+//written as the change from base, so the values a delta stores stay small
+static void SerializeZigZagDelta(FArchive& archive, FIntVector& value, const FIntVector& base)
+{
+	FIntVector delta = value - base;
+	SerializeZigZag(archive, delta);
+	if (archive.IsLoading()) value = base + delta;
+}
+
+static bool SerializeBit(FArchive& archive, bool value)
+{
+	uint8 bit = (value) ? 1 : 0;
+	archive.SerializeBits(&bit, 1);
+	return bit != 0;
+}
+
+void FRopeSnapshot::Capture(const FRopeSimulation& simulation, const TArray<FRopeWrap>& wraps_, float quantizationStep_)
+{
+	quantizationStep = FMath::Max(quantizationStep_, KINDA_SMALL_NUMBER);
+	int count = simulation.Num();
+	anchor = (count > 0) ? simulation.GetPosition(simulation.GetAnchorIndex()) : FVector::ZeroVector;
+
+	auto Quantize = [this](const FVector& location) {
+		FVector offset = (location - anchor) / quantizationStep;
+		return FIntVector(FMath::RoundToInt(offset.X), FMath::RoundToInt(offset.Y), FMath::RoundToInt(offset.Z));
+	};
+
+	//velocity is taken between the quantized positions, so a restored point moves exactly as far as the snapshot says
+	positions.SetNumUninitialized(count);
+	velocities.SetNumUninitialized(count);
+	flags.SetNumUninitialized(count);
+	for (int i = 0; i < count; ++i) {
+		positions[i] = Quantize(simulation.GetPosition(i));
+		velocities[i] = positions[i] - Quantize(simulation.GetPreviousPosition(i));
+		flags[i] = (uint8)simulation.flags[i];
+	}
+
+	wraps.Reset();
+	for (const FRopeWrap& wrap : wraps_) {
+		wraps.Add({ wrap.index, FVector3f(wrap.edgeNormal) });
+	}
+
+	realDistanceBetweenPoints = simulation.realDistanceBetweenPoints;
+	ropeLength = simulation.ropeLength;
+	transitionaryOutIndex = simulation.transitionaryOutIndex;
+	transitionaryInIndex = simulation.transitionaryInIndex;
+	transitionaryOutDistance = simulation.transitionaryOutDistance;
+	transitionaryInDistance = simulation.transitionaryInDistance;
+
+	gravitationalAcceleration = simulation.gravitationalAcceleration;
+	defaultInverseMass = simulation.defaultInverseMass;
+	pointRadius = simulation.pointRadius;
+	stiffness = simulation.stiffness;
+	initialGiveMultiplier = simulation.initialGiveMultiplier;
+}
+
+void FRopeSnapshot::Apply(FRopeSimulation& simulation, TArray<FRopeWrap>& outWraps) const
+{
+	//the rope carries on from the snapshot's motion; collision history and the last residual start over
+	simulation.Reset();
+	for (int i = 0; i < positions.Num(); ++i) {
+		//points are only marked wrapped below, for the wraps that are actually restored
+		ERopePointFlags pointFlags = (ERopePointFlags)flags[i] & ~ERopePointFlags::Wrapped;
+		FVector position = GetPosition(i);
+		FVector previousPosition = anchor + FVector(positions[i] - velocities[i]) * quantizationStep;
+		int ind = simulation.AddPoint(FVector4f(FVector3f(position), 0.0f), EnumHasAnyFlags(pointFlags, ERopePointFlags::Anchor) ? 0.0f : defaultInverseMass);
+		simulation.previousPositions[ind] = FVector4f(FVector3f(previousPosition), 0.0f);
+		simulation.flags[ind] = pointFlags;
+	}
+
+	simulation.realDistanceBetweenPoints = realDistanceBetweenPoints;
+	simulation.ropeLength = ropeLength;
+	simulation.transitionaryOutIndex = transitionaryOutIndex;
+	simulation.transitionaryInIndex = transitionaryInIndex;
+	simulation.transitionaryOutDistance = transitionaryOutDistance;
+	simulation.transitionaryInDistance = transitionaryInDistance;
+
+	simulation.gravitationalAcceleration = gravitationalAcceleration;
+	simulation.defaultInverseMass = defaultInverseMass;
+	simulation.pointRadius = pointRadius;
+	simulation.stiffness = stiffness;
+	simulation.initialGiveMultiplier = initialGiveMultiplier;
+
+	outWraps.Reset();
+	for (const FWrap& wrap : wraps) {
+		if (wrap.index <= 0 || wrap.index >= simulation.GetTransitionaryInIndex() - 1 || simulation.HasFlag(wrap.index, ERopePointFlags::Wrapped)) continue;
+		outWraps.Add({ wrap.index, simulation.GetPosition(wrap.index), FVector(wrap.edgeNormal) });
+		simulation.SetFlag(wrap.index, ERopePointFlags::Wrapped);
+	}
+}
+
+void FRopeSnapshot::Serialize(FArchive& archive)
+{
+	SerializeShared(archive);
+
+	int32 count = positions.Num();
+	SerializeZigZag(archive, count);
+	if (!IsValid(count)) {
+		archive.SetError();
+		return;
+	}
+	if (archive.IsLoading()) {
+		positions.SetNumZeroed(count);
+		velocities.SetNumZeroed(count);
+		flags.SetNumZeroed(count);
+	}
+	for (int i = 0; i < count; ++i) {
+		SerializeZigZag(archive, positions[i]);
+		SerializeZigZag(archive, velocities[i]);
+		archive.SerializeBits(&flags[i], 2);
+	}
+
+	SerializeWraps(archive);
+}
+
+void FRopeSnapshot::SerializeDelta(FArchive& archive, const FRopeSnapshot& base)
+{
+	//the constants rarely change, but the anchor moves with anything the rope is tied to
+	bool sharedChanged = !anchor.Equals(base.anchor, 0.0f) || quantizationStep != base.quantizationStep || realDistanceBetweenPoints != base.realDistanceBetweenPoints ||
+		ropeLength != base.ropeLength || transitionaryOutIndex != base.transitionaryOutIndex || transitionaryInIndex != base.transitionaryInIndex ||
+		transitionaryOutDistance != base.transitionaryOutDistance || transitionaryInDistance != base.transitionaryInDistance ||
+		gravitationalAcceleration != base.gravitationalAcceleration || defaultInverseMass != base.defaultInverseMass || pointRadius != base.pointRadius ||
+		stiffness != base.stiffness || initialGiveMultiplier != base.initialGiveMultiplier;
+	if (SerializeBit(archive, sharedChanged)) SerializeShared(archive);
+	else if (archive.IsLoading()) {
+		anchor = base.anchor;
+		quantizationStep = base.quantizationStep;
+		realDistanceBetweenPoints = base.realDistanceBetweenPoints;
+		ropeLength = base.ropeLength;
+		transitionaryOutIndex = base.transitionaryOutIndex;
+		transitionaryInIndex = base.transitionaryInIndex;
+		transitionaryOutDistance = base.transitionaryOutDistance;
+		transitionaryInDistance = base.transitionaryInDistance;
+		gravitationalAcceleration = base.gravitationalAcceleration;
+		defaultInverseMass = base.defaultInverseMass;
+		pointRadius = base.pointRadius;
+		stiffness = base.stiffness;
+		initialGiveMultiplier = base.initialGiveMultiplier;
+	}
+
+	int32 count = positions.Num();
+	SerializeZigZag(archive, count);
+	if (!IsValid(count)) {
+		archive.SetError();
+		return;
+	}
+	if (archive.IsLoading()) {
+		positions.SetNumZeroed(count);
+		velocities.SetNumZeroed(count);
+		flags.SetNumZeroed(count);
+	}
+
+	//points the base doesn't have are written against zero; every other point is a single bit unless it moved
+	for (int i = 0; i < count; ++i) {
+		bool inBase = i < base.Num();
+		FIntVector basePosition = (inBase) ? base.positions[i] : FIntVector::ZeroValue;
+		FIntVector baseVelocity = (inBase) ? base.velocities[i] : FIntVector::ZeroValue;
+		uint8 baseFlags = (inBase) ? base.flags[i] : 0;
+		bool changed = !inBase || positions[i] != basePosition || velocities[i] != baseVelocity || flags[i] != baseFlags;
+		if (!SerializeBit(archive, changed)) {
+			if (archive.IsLoading()) {
+				positions[i] = basePosition;
+				velocities[i] = baseVelocity;
+				flags[i] = baseFlags;
+			}
+			continue;
+		}
+
+		SerializeZigZagDelta(archive, positions[i], basePosition);
+		SerializeZigZagDelta(archive, velocities[i], baseVelocity);
+		archive.SerializeBits(&flags[i], 2);
+	}
+
+	SerializeWraps(archive);
+}
+
+bool FRopeSnapshot::IsValid(int32 count) const
+{
+	//the anchor is the last point with the transitionary out and in points just before it, and the solver indexes them without checking
+	if (count < 3 || count > maxSnapshotPoints || transitionaryOutIndex != count - 2 || transitionaryInIndex != count - 3) return false;
+
+	//every position is dequantized through the step and every segment rests at these lengths, so one bad value would spread NaNs through the rope
+	auto IsPositive = [](float value) { return FMath::IsFinite(value) && value > 0.0f; };
+	auto IsNonNegative = [](float value) { return FMath::IsFinite(value) && value >= 0.0f; };
+	auto IsWithin = [](float value, float limit) { return FMath::IsFinite(value) && FMath::Abs(value) <= limit; };
+	return !anchor.ContainsNaN() && FMath::IsFinite(quantizationStep) && quantizationStep >= KINDA_SMALL_NUMBER && IsPositive(realDistanceBetweenPoints) &&
+		IsPositive(ropeLength) && IsWithin(transitionaryOutDistance, realDistanceBetweenPoints) && IsWithin(transitionaryInDistance, realDistanceBetweenPoints) &&
+		!gravitationalAcceleration.ContainsNaN() && IsNonNegative(defaultInverseMass) && IsNonNegative(pointRadius) && IsPositive(stiffness) &&
+		IsPositive(initialGiveMultiplier);
+}
+
+void FRopeSnapshot::SerializeShared(FArchive& archive)
+{
+	archive << anchor << quantizationStep;
+	archive << realDistanceBetweenPoints << ropeLength << transitionaryOutDistance << transitionaryInDistance;
+	SerializeZigZag(archive, transitionaryOutIndex);
+	SerializeZigZag(archive, transitionaryInIndex);
+	archive << gravitationalAcceleration << defaultInverseMass << pointRadius << stiffness << initialGiveMultiplier;
+}
+
+void FRopeSnapshot::SerializeWraps(FArchive& archive)
+{
+	//there are rarely more than a couple of wraps, and their edge normals only need to point the right way
+	int32 count = wraps.Num();
+	SerializeZigZag(archive, count);
+	if (count < 0 || count > maxSnapshotPoints) {
+		archive.SetError();
+		return;
+	}
+	if (archive.IsLoading()) wraps.SetNum(count);
+	for (FWrap& wrap : wraps) {
+		SerializeZigZag(archive, wrap.index);
+		FIntVector normal(FMath::RoundToInt(wrap.edgeNormal.X * 127), FMath::RoundToInt(wrap.edgeNormal.Y * 127), FMath::RoundToInt(wrap.edgeNormal.Z * 127));
+		SerializeZigZag(archive, normal);
+		if (archive.IsLoading()) wrap.edgeNormal = FVector3f(normal.X, normal.Y, normal.Z).GetSafeNormal();
+	}
+}
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RopeSimulation.h"
+
+struct FRopeWrap;
+
+/**
+ * Compact rope state for save games, replays and replication. Point positions are quantized to a fixed step
+ * relative to the anchor and velocities are the quantized step to the previous position, each written as a
+ * zigzagged packed integer, so a point usually costs around ten bytes against the hundred or so of a
+ * serialized URopePoint. Per-rope constants are written once per snapshot instead of per point, and a delta
+ * against an earlier snapshot only writes the points that changed, a single bit for each one that didn't.
+ * Sizes are smallest through a bit archive such as FBitWriter.
+ */
+struct ROPEGRAPPLE_API FRopeSnapshot
+{
+	void Capture(const FRopeSimulation& simulation, const TArray<FRopeWrap>& wraps, float quantizationStep_);
+	void Apply(FRopeSimulation& simulation, TArray<FRopeWrap>& outWraps) const;
+	void Serialize(FArchive& archive);
+	void SerializeDelta(FArchive& archive, const FRopeSnapshot& base);
+	int Num() const { return positions.Num(); };
+	FVector GetPosition(int ind) const { return anchor + FVector(positions[ind]) * quantizationStep; };
+
+	//a wrapped point's position is already in the snapshot, so only the edge it presses into is kept
+	struct FWrap
+	{
+		int32 index = INDEX_NONE;
+		FVector3f edgeNormal = FVector3f::ZeroVector;
+	};
+
+	FVector anchor = FVector::ZeroVector;
+	float quantizationStep = 0.1f;
+	TArray<FIntVector> positions;
+	TArray<FIntVector> velocities;
+	TArray<uint8> flags;
+	TArray<FWrap> wraps;
+
+	float realDistanceBetweenPoints = 0.0f;
+	float ropeLength = 0.0f;
+	int32 transitionaryOutIndex = INDEX_NONE;
+	int32 transitionaryInIndex = INDEX_NONE;
+	float transitionaryOutDistance = 0.0f;
+	float transitionaryInDistance = 0.0f;
+
+	FVector3f gravitationalAcceleration = FVector3f::ZeroVector;
+	float defaultInverseMass = 0.0f;
+	float pointRadius = 0.0f;
+	float stiffness = 0.0f;
+	float initialGiveMultiplier = 0.0f;
+
+protected:
+	bool IsValid(int32 count) const;
+	void SerializeShared(FArchive& archive);
+	void SerializeWraps(FArchive& archive);
+};
@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+//where the grapple's frame time goes, shown by `stat Rope` and recorded in CSV profiler captures under the Rope category
+DECLARE_STATS_GROUP(TEXT("Rope"), STATGROUP_Rope, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces Issued"), STAT_RopeTraces, STATGROUP_Rope, ROPEGRAPPLE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Segments Alive"), STAT_RopeSegments, STATGROUP_Rope, ROPEGRAPPLE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Iterations Executed"), STAT_RopeIterations, STATGROUP_Rope, ROPEGRAPPLE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("UObjects Created"), STAT_RopeObjectsCreated, STATGROUP_Rope, ROPEGRAPPLE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("UObjects Destroyed"), STAT_RopeObjectsDestroyed, STATGROUP_Rope, ROPEGRAPPLE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Snapshot Bytes Sent"), STAT_RopeSnapshotBytes, STATGROUP_Rope, ROPEGRAPPLE_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(ROPEGRAPPLE_API, Rope);
+
+//times a scope as STAT_Rope<Name> and as the CSV timing stat <Name>; cycle counters already show up as CPU scopes in Insights,
+//so builds compiled without stats keep a plain trace scope instead
+#if STATS
+#define SCOPE_ROPE_CYCLE_COUNTER(Name) SCOPE_CYCLE_COUNTER(STAT_Rope##Name); CSV_SCOPED_TIMING_STAT(Rope, Name)
+#else
+#define SCOPE_ROPE_CYCLE_COUNTER(Name) TRACE_CPUPROFILER_EVENT_SCOPE(Rope##Name); CSV_SCOPED_TIMING_STAT(Rope, Name)
+#endif
+
+//adds to one of the counters above and to the CSV stat of the same name, which sums over the frame
+#define INC_ROPE_COUNTER(Name, Amount) do { INC_DWORD_STAT_BY(STAT_Rope##Name, Amount); CSV_CUSTOM_STAT(Rope, Name, (int32)(Amount), ECsvCustomStatOp::Accumulate); } while (0)
@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RopeWorldSubsystem.h"
+#include "Rope.h"
+#include "RopeReplay.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRopeRecording, Log, All);
+
+static FAutoConsoleCommandWithWorld RopeStartRecordingCommand(
+	TEXT("rope.StartRecording"),
+	TEXT("Records every rope in the world, and every rope fired after it, until rope.StopRecording. Play them back with -run=RopeReplay."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* world) {
+		if (URopeWorldSubsystem* ropeWorld = (world) ? world->GetSubsystem<URopeWorldSubsystem>() : nullptr) ropeWorld->StartRecording();
+	}));
+
+static FAutoConsoleCommandWithWorld RopeStopRecordingCommand(
+	TEXT("rope.StopRecording"),
+	TEXT("Stops recording ropes and saves each recording under Saved/RopeReplays."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* world) {
+		if (URopeWorldSubsystem* ropeWorld = (world) ? world->GetSubsystem<URopeWorldSubsystem>() : nullptr) ropeWorld->StopRecording();
+	}));
+
+void FRopeSimulateTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (subsystem) subsystem->BeginSimulation(DeltaTime);
+}
+
+void FRopeApplyTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (subsystem) subsystem->FinishSimulation();
+}
+
+void URopeWorldSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	//the solve overlaps everything else ticking during physics and is only needed again once physics is done
+	simulateTickFunction.subsystem = this;
+	simulateTickFunction.TickGroup = TG_DuringPhysics;
+	simulateTickFunction.bCanEverTick = true;
+	simulateTickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+
+	applyTickFunction.subsystem = this;
+	applyTickFunction.TickGroup = TG_PostPhysics;
+	applyTickFunction.bCanEverTick = true;
+	applyTickFunction.AddPrerequisite(this, simulateTickFunction);
+	applyTickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+}
+
+void URopeWorldSubsystem::Deinitialize()
+{
+	WaitForSimulation();
+	simulateTickFunction.UnRegisterTickFunction();
+	applyTickFunction.UnRegisterTickFunction();
+	Super::Deinitialize();
+}
+
+void URopeWorldSubsystem::RegisterRope(ARope* rope)
+{
+	if (!IsValid(rope)) return;
+	activeRopes.AddUnique(rope);
+	if (recording && !rope->IsRecording()) rope->StartRecording();
+}
+
+void URopeWorldSubsystem::UnregisterRope(ARope* rope)
+{
+	//a rope going back to the pool may still be in the middle of its simulate stage
+	WaitForSimulation();
+	activeRopes.Remove(rope);
+
+	//the rope's points are about to be reset, so its recording ends here
+	if (IsValid(rope) && rope->IsRecording()) SaveRecording(rope);
+}
+
+void URopeWorldSubsystem::BeginSimulation(float DeltaTime)
+{
+	WaitForSimulation();
+
+	//ropes destroyed without being returned to the pool just drop out
+	activeRopes.RemoveAll([](ARope* rope) { return !IsValid(rope); });
+
+	simulatingRopes.Reset();
+	for (ARope* rope : activeRopes) {
+		if (rope->GatherInput(DeltaTime) > 0) simulatingRopes.Add(rope);
+	}
+	if (simulatingRopes.Num() == 0) return;
+
+	//ropes differ a lot in length, so let the task system balance them
+	simulationTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this]() {
+		ParallelFor(simulatingRopes.Num(), [this](int i) { simulatingRopes[i]->Simulate(); }, EParallelForFlags::Unbalanced);
+	});
+}
+
+void URopeWorldSubsystem::FinishSimulation()
+{
+	WaitForSimulation();
+	for (ARope* rope : activeRopes) {
+		if (IsValid(rope)) rope->ApplyOutput();
+	}
+}
+
+void URopeWorldSubsystem::WaitForSimulation()
+{
+	if (!simulationTask.IsValid()) return;
+	simulationTask.Wait();
+	simulationTask = UE::Tasks::FTask();
+}
+
+void URopeWorldSubsystem::StartRecording()
+{
+	recording = true;
+	for (ARope* rope : activeRopes) {
+		if (IsValid(rope) && !rope->IsRecording()) rope->StartRecording();
+	}
+}
+
+int URopeWorldSubsystem::StopRecording()
+{
+	recording = false;
+	int saved = 0;
+	for (ARope* rope : activeRopes) {
+		if (!IsValid(rope) || !rope->IsRecording()) continue;
+		SaveRecording(rope);
+		++saved;
+	}
+	return saved;
+}
+
+void URopeWorldSubsystem::SaveRecording(ARope* rope)
+{
+	TSharedPtr<FRopeRecording> finished = rope->StopRecording();
+	if (!finished) return;
+
+	FString path = FPaths::ProjectSavedDir() / TEXT("RopeReplays") / FString::Printf(TEXT("%s_%s.roperecording"), *rope->GetName(), *FDateTime::Now().ToString());
+	if (finished->SaveToFile(path)) UE_LOG(LogRopeRecording, Display, TEXT("Saved %d rope frames to %s"), finished->frames.Num(), *path);
+	else UE_LOG(LogRopeRecording, Error, TEXT("Could not write %s"), *path);
+}
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Tasks/Task.h"
+#include "RopeWorldSubsystem.generated.h"
+
+class ARope;
+class URopeWorldSubsystem;
+
+//gathers every rope's input on the game thread and starts their simulate stage on workers
+USTRUCT()
+struct FRopeSimulateTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	URopeWorldSubsystem* subsystem = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override { return TEXT("FRopeSimulateTickFunction"); };
+};
+
+template<>
+struct TStructOpsTypeTraits<FRopeSimulateTickFunction> : public TStructOpsTypeTraitsBase2<FRopeSimulateTickFunction>
+{
+	enum { WithCopy = false };
+};
+
+//waits for the simulate stage and applies every rope's output on the game thread
+USTRUCT()
+struct FRopeApplyTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	URopeWorldSubsystem* subsystem = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override { return TEXT("FRopeApplyTickFunction"); };
+};
+
+template<>
+struct TStructOpsTypeTraits<FRopeApplyTickFunction> : public TStructOpsTypeTraitsBase2<FRopeApplyTickFunction>
+{
+	enum { WithCopy = false };
+};
+
+/**
+ * Steps every active rope in the world as a three stage pipeline. During physics each rope gathers what
+ * it needs from the world on the game thread, then all ropes are simulated on workers while the rest of
+ * the frame keeps ticking. After physics the game thread waits for them and applies the results, moving
+ * the player or pulled object and updating the rope's visuals.
+ */
+UCLASS()
+class ROPEGRAPPLE_API URopeWorldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override { return WorldType == EWorldType::Game || WorldType == EWorldType::PIE; };
+
+	void RegisterRope(ARope* rope);
+	void UnregisterRope(ARope* rope);
+	int GetActiveRopeCount() const { return activeRopes.Num(); };
+
+	void BeginSimulation(float DeltaTime);
+	void FinishSimulation();
+	void WaitForSimulation();
+
+	void StartRecording();
+	int StopRecording();
+
+protected:
+	void SaveRecording(ARope* rope);
+
+	UPROPERTY()
+		TArray<ARope*> activeRopes;
+
+	TArray<ARope*> simulatingRopes;
+	UE::Tasks::FTask simulationTask;
+	FRopeSimulateTickFunction simulateTickFunction;
+	FRopeApplyTickFunction applyTickFunction;
+	bool recording = false;
+};